@@ -11,11 +11,15 @@
 #include <errno.h>
 #include <cstring>
 #include <sys/stat.h>
+#include <sys/resource.h>
 #include <cstdio>
+#include <cmath>
 #include <filesystem>
 #include <fstream>
 #include <unordered_map>
 #include <algorithm>
+#include <memory>
+#include <thread>
 // #include "debug/memwrap.h"  // Disabled
 
 // Quackle headers (core only, no Qt)
@@ -34,6 +38,20 @@
 #include "gameparameters.h"
 #include "strategyparameters.h"
 
+// Wrapper-side move generator (parallel mode)
+#include "gen/exchange.h"
+#include "gen/leave_file.h"
+#include "gen/lexicon_registry.h"
+#include "gen/mapped_graph.h"
+#include "gen/move_store.h"
+#include "gen/movegen.h"
+#include "gen/published.h"
+#include "gen/quackle_adapter.h"
+#include "gen/residency.h"
+#include "gen/ruleset.h"
+#include "gen/shared_board.h"
+#include "gen/work_pool.h"
+
 using json = nlohmann::json;
 
 struct Config {
@@ -41,8 +59,21 @@ struct Config {
     std::string dawg_path;
     std::string ruleset = "en";
     std::string use_lexicon = "gaddag"; // "gaddag" or "dawg"
+    int gen_threads = 0;                // 0 = one per hardware thread
+    std::string leaves_path;            // dense leave table from tools/makeleaves
+    std::string mapped_gaddag_path;     // GADDAG from tools/mapgaddag, used in place of Quackle's
+    int page_entries = 64;              // move lists kept for moves_page
+    int page_moves = 2000000;           // candidates kept across those lists
+    int page_ttl_ms = 300000;           // idle time before a cursor expires
+    std::vector<std::string> lexica;    // "name=path" mapped GADDAGs picked by a request's "lexicon"
+    int lexica_cap_mb = 0;              // resident mapped lexica before LRU eviction; 0 = no cap
+    std::vector<std::string> rulesets;  // "name:key=value,..." contexts served beside "en"
+    wrapper::ResidencyOptions residency; // huge pages, mlock and NUMA node for the mapped tables
 };
 
+// Largest page moves_page serves at once
+static constexpr long long kMaxPageSize = 500;
+
 // Simple signature-based word index for empty-board fast path
 static std::unordered_map<std::string, std::vector<std::string>> g_sig_index;
 static bool g_sig_index_ready = false;
@@ -148,7 +179,7 @@ static void validate_and_normalize_rack(std::string &rackStr) {
 }
 
 static void validate_board_cell(int row, int col, const std::string &cell) {
-    if (row < 0 || row > 14 || col < 0 || col > 14) {
+    if (row < 0 || row >= wrapper::kBoardDim || col < 0 || col >= wrapper::kBoardDim) {
         std::fprintf(stderr, "[wrapper] ERROR: invalid cell coordinates: (%d,%d)\n", row, col);
         throw std::runtime_error("invalid cell coordinates");
     }
@@ -203,9 +234,9 @@ static void log_lexicon_diagnostics(const std::string &ruleset,
 }
 
 static bool json_board_is_empty(const nlohmann::json& grid) {
-    if (!grid.is_array() || grid.size() != 15) return false;
+    if (!grid.is_array() || grid.size() != static_cast<size_t>(wrapper::kBoardDim)) return false;
     for (const auto& row : grid) {
-        if (!row.is_array() || row.size() != 15) return false;
+        if (!row.is_array() || row.size() != static_cast<size_t>(wrapper::kBoardDim)) return false;
         for (const auto& cell : row) {
             // Check if cell is not null (empty) and not empty string
             if (!cell.is_null()) {
@@ -222,6 +253,217 @@ static bool json_board_is_empty(const nlohmann::json& grid) {
     return true;
 }
 
+// Optional "constraints" object of a compute request, applied inside the
+// wrapper generator:
+//   {"direction":"H"|"V", "cover":[row,col], "min_length":n, "max_length":n,
+//    "must_use":"LETTERS", "use_all":true}
+static void parse_constraints(const nlohmann::json &in, wrapper::GenConstraints &out) {
+    if (!in.is_object()) throw std::runtime_error("constraints must be an object");
+    if (in.contains("direction")) {
+        const std::string dir = in["direction"].is_string() ? in["direction"].get<std::string>() : std::string();
+        if (dir == "H") out.directions = wrapper::GenConstraints::kAcross;
+        else if (dir == "V") out.directions = wrapper::GenConstraints::kDown;
+        else throw std::runtime_error("constraints.direction must be H or V");
+    }
+    if (in.contains("cover")) {
+        const auto &cover = in["cover"];
+        if (!cover.is_array() || cover.size() != 2 || !cover[0].is_number_integer() || !cover[1].is_number_integer())
+            throw std::runtime_error("constraints.cover must be [row, col]");
+        out.cover_row = cover[0].get<int>();
+        out.cover_col = cover[1].get<int>();
+        if (out.cover_row < 0 || out.cover_row >= wrapper::kBoardDim || out.cover_col < 0 ||
+            out.cover_col >= wrapper::kBoardDim)
+            throw std::runtime_error("constraints.cover is off the board");
+    }
+    for (const char *key : {"min_length", "max_length"}) {
+        if (!in.contains(key)) continue;
+        if (!in[key].is_number_integer()) throw std::runtime_error(std::string("constraints.") + key + " must be an integer");
+        const int length = in[key].get<int>();
+        if (length < 1 || length > wrapper::kBoardDim)
+            throw std::runtime_error(std::string("constraints.") + key + " must be 1.." +
+                                     std::to_string(wrapper::kBoardDim));
+        (std::strcmp(key, "min_length") == 0 ? out.min_length : out.max_length) = length;
+    }
+    if (out.max_length && out.min_length > out.max_length)
+        throw std::runtime_error("constraints.min_length exceeds max_length");
+    if (in.contains("must_use")) {
+        if (!in["must_use"].is_string()) throw std::runtime_error("constraints.must_use must be a string");
+        for (char c : to_upper(in["must_use"].get<std::string>())) {
+            if (!is_upper_letter(c)) throw std::runtime_error("constraints.must_use takes letters A-Z");
+            out.must_use.add(static_cast<uint8_t>(c - 'A' + 1));
+        }
+    }
+    if (in.contains("use_all")) {
+        if (!in["use_all"].is_boolean()) throw std::runtime_error("constraints.use_all must be a boolean");
+        out.use_all = in["use_all"].get<bool>();
+    }
+}
+
+// Rack and board tiles of a ruleset context must come from its alphabet
+static bool context_letters_ok(const wrapper::RulesetContext &context, const wrapper::RackCounts &rack,
+                               const wrapper::BoardState &state) {
+    if (!context.has_letters(rack)) return false;
+    for (int r = 0; r < wrapper::kBoardDim; ++r)
+        for (int c = 0; c < wrapper::kBoardDim; ++c)
+            if (state.tile(r, c) && !context.has_letter(wrapper::tile_letter(state.tile(r, c)))) return false;
+    return true;
+}
+
+// Board for the wrapper generator, filled in place (validated like the Quackle path)
+static void fill_board_state(const nlohmann::json &cells, wrapper::BoardState &state) {
+    state.clear();
+    for (int r = 0; r < wrapper::kBoardDim; ++r) {
+        const auto &row = cells[r];
+        for (int c = 0; c < wrapper::kBoardDim; ++c) {
+            std::string cell;
+            try { cell = row[c].get<std::string>(); } catch (...) { cell.clear(); }
+            if (cell.empty() || cell == " ") continue;
+            validate_board_cell(r, c, cell);
+            char ch = std::toupper(static_cast<unsigned char>(cell[0]));
+            state.set_tile(r, c, static_cast<uint8_t>(ch - 'A' + 1));
+        }
+    }
+}
+
+// Quackle objects reused across requests on the serving thread. Each compute
+// resets rack and bag instead of constructing a fresh player list, position
+// and generator. `pos` keeps an empty board; request tiles are placed on the
+// generator's copy only.
+static Quackle::PlayerList make_players() {
+    Quackle::PlayerList players;
+    players.push_back( Quackle::Player("A", 1, 0) );  // HumanPlayerType = 1
+    players.push_back( Quackle::Player("B", 1, 1) );  // HumanPlayerType = 1
+    return players;
+}
+
+struct QuackleContext {
+    Quackle::PlayerList players;
+    Quackle::GamePosition pos;
+    Quackle::Generator gen;
+    Quackle::Bag bag;  // not modelled; every request gets the same bag
+
+    QuackleContext() : players(make_players()), pos(players) {
+        pos.underlyingBoardReference().prepareEmptyBoard();
+    }
+};
+
+// Created on first use, once the DataManager is fully set up
+static QuackleContext &quackle_context() {
+    thread_local QuackleContext ctx;
+    return ctx;
+}
+
+// Wrapper-generator replies are written straight into a reused buffer instead
+// of a json tree. Keys are emitted in the order json::dump() would use.
+static void append_candidate_json(std::string &out, const wrapper::Candidate &mv) {
+    char buf[32];
+    std::snprintf(buf, sizeof(buf), "{\"col\":%d,\"dir\":\"%c\",", mv.col, mv.horizontal() ? 'H' : 'V');
+    out += buf;
+    out += "\"positions\":[";
+    for (int i = 0; i < mv.length(); ++i) {
+        int rr = mv.row + (mv.horizontal() ? 0 : i);
+        int cc = mv.col + (mv.horizontal() ? i : 0);
+        std::snprintf(buf, sizeof(buf), "%s[%d,%d]", i ? "," : "", rr, cc);
+        out += buf;
+    }
+    out += "],\"row\":";
+    out += std::to_string(mv.row);
+    out += ",\"score\":";
+    out += std::to_string(mv.score);
+    out += ",\"word\":\"";
+    for (int i = 0; i < mv.length(); ++i) {
+        const uint8_t tile = mv.tile(i);
+        const char ch = static_cast<char>('A' + wrapper::tile_letter(tile) - 1);
+        out.push_back(wrapper::tile_is_blank(tile) ? static_cast<char>(std::tolower(ch)) : ch);
+    }
+    out += "\"}";
+}
+
+static void append_rack_letters(std::string &out, const wrapper::RackCounts &tiles) {
+    for (int l = 1; l < wrapper::kMaxLetters; ++l)
+        out.append(tiles.counts[l], static_cast<char>('A' + l - 1));
+    out.append(tiles.blanks, '?');
+}
+
+// Where one mapped table lives, for probe_lexicon
+template <class Table>
+static json residency_json(const std::string &name, const Table &table) {
+    const wrapper::Residency &r = table.residency();
+    return { {"name", name}, {"bytes", table.bytes()}, {"in_memory_bytes", table.resident_bytes()},
+             {"huge_page_bytes", table.huge_page_bytes()}, {"copied", r.copied}, {"hugetlb", r.hugetlb},
+             {"locked", r.locked}, {"numa_node", r.numa_node},
+             {"error", r.error.empty() ? json(nullptr) : json(r.error)} };
+}
+
+// Lexicon hot reload (op "reload_lexicon"): the replacement is loaded and
+// checked on its own thread while requests keep being served, and the loop
+// publishes it between two requests. A compute still holding the old mapped
+// graph keeps it alive until it returns.
+struct LexiconReload {
+    std::string path;
+    std::string type;  // "GADDAG", "DAWG" or "MAPPED"
+    std::thread worker;
+    std::atomic<bool> done{false};
+    // Written by the worker before `done`
+    std::shared_ptr<wrapper::MappedGraph> mapped;
+    Quackle::LexiconParameters *params = nullptr;
+    std::string error;
+    wrapper::ResidencyOptions residency;
+};
+
+static void load_lexicon(LexiconReload &reload) {
+    try {
+        if (reload.type == "MAPPED") {
+            auto graph = std::make_shared<wrapper::MappedGraph>();
+            std::string error;
+            if (graph->open(reload.path, error)) {
+                graph->apply_residency(reload.residency);
+                reload.mapped = std::move(graph);
+            } else {
+                reload.error = error;
+            }
+        } else if (!std::filesystem::exists(reload.path)) {
+            reload.error = "file not found";
+        } else {
+            auto params = std::make_unique<Quackle::LexiconParameters>();
+            if (reload.type == "GADDAG") params->loadGaddag(reload.path);
+            else params->loadDawg(reload.path);
+            // Quackle's loaders log and leave the graph empty on a bad file
+            if (reload.type == "GADDAG" ? params->hasGaddag() : params->hasDawg()) reload.params = params.release();
+            else reload.error = "not a loadable " + reload.type;
+        }
+    } catch (const std::exception &e) {
+        reload.error = e.what();
+    } catch (...) {
+        reload.error = "unknown exception";
+    }
+    reload.done.store(true, std::memory_order_release);
+}
+
+// Best exchange, reported beside the placements; `beats_moves` says whether
+// it outranks the best placement by equity
+static void append_exchange_json(std::string &out, const wrapper::Exchange &ex, bool beats_moves) {
+    char buf[64];
+    std::snprintf(buf, sizeof(buf), "{\"action\":\"exchange\",\"beats_moves\":%s,\"equity\":%.3f,\"keep\":\"",
+                  beats_moves ? "true" : "false", wrapper::equity_value(ex.equity));
+    out += buf;
+    append_rack_letters(out, ex.keep);
+    out += "\",\"score\":0,\"tiles\":\"";
+    append_rack_letters(out, ex.tiles);
+    out += "\"}";
+}
+
+// The same exchange as a json value, for replies built with nlohmann; equity
+// is rounded to the 3 decimals append_exchange_json prints
+static json exchange_json(const wrapper::Exchange &ex, bool beats_moves) {
+    std::string keep, tiles;
+    append_rack_letters(keep, ex.keep);
+    append_rack_letters(tiles, ex.tiles);
+    return { {"action", "exchange"}, {"beats_moves", beats_moves},
+             {"equity", std::round(wrapper::equity_value(ex.equity) * 1000.0) / 1000.0},
+             {"keep", keep}, {"score", 0}, {"tiles", tiles} };
+}
+
 int main(int argc, char** argv) {
     Config cfg;
     for (int i=1; i<argc; ++i) {
@@ -230,9 +472,21 @@ int main(int argc, char** argv) {
         else if (a == "--dawg" && i+1 < argc) cfg.dawg_path = argv[++i];
         else if (a == "--ruleset" && i+1 < argc) cfg.ruleset = argv[++i];
         else if (a == "--use" && i+1 < argc) cfg.use_lexicon = argv[++i];
+        else if (a == "--gen-threads" && i+1 < argc) cfg.gen_threads = std::atoi(argv[++i]);
+        else if (a == "--leaves" && i+1 < argc) cfg.leaves_path = argv[++i];
+        else if (a == "--mapped-gaddag" && i+1 < argc) cfg.mapped_gaddag_path = argv[++i];
+        else if (a == "--page-entries" && i+1 < argc) cfg.page_entries = std::atoi(argv[++i]);
+        else if (a == "--page-moves" && i+1 < argc) cfg.page_moves = std::atoi(argv[++i]);
+        else if (a == "--page-ttl-ms" && i+1 < argc) cfg.page_ttl_ms = std::atoi(argv[++i]);
+        else if (a == "--lexicon" && i+1 < argc) cfg.lexica.push_back(argv[++i]);
+        else if (a == "--lexica-cap-mb" && i+1 < argc) cfg.lexica_cap_mb = std::atoi(argv[++i]);
+        else if (a == "--ruleset-context" && i+1 < argc) cfg.rulesets.push_back(argv[++i]);
+        else if (a == "--huge-pages") cfg.residency.huge_pages = true;
+        else if (a == "--mlock") cfg.residency.lock = true;
+        else if (a == "--numa-node" && i+1 < argc) cfg.residency.numa_node = std::atoi(argv[++i]);
     }
 
-    if (cfg.gaddag_path.empty() && cfg.dawg_path.empty()) {
+    if (cfg.gaddag_path.empty() && cfg.dawg_path.empty() && cfg.mapped_gaddag_path.empty()) {
         std::fprintf(stderr, "[wrapper] start pid=%d\n", getpid());
         std::fprintf(stderr, "[wrapper] lexicon_load_error both paths empty\n");
         return 1;
@@ -241,9 +495,13 @@ int main(int argc, char** argv) {
     std::fprintf(stderr, "[wrapper] start pid=%d\n", getpid());
     std::fprintf(stderr, "[wrapper] use_lexicon=%s\n", cfg.use_lexicon.c_str());
     
-    // Validate ruleset - must be English
-    if (cfg.ruleset != "en") {
-        std::fprintf(stderr, "[wrapper] ERROR: ruleset must be 'en', got '%s'\n", cfg.ruleset.c_str());
+    // Validate ruleset - English (Quackle's own) or a --ruleset-context
+    const bool ruleset_defined = cfg.ruleset == "en" ||
+        std::any_of(cfg.rulesets.begin(), cfg.rulesets.end(),
+                    [&cfg](const std::string &spec) { return spec.rfind(cfg.ruleset + ":", 0) == 0; });
+    if (!ruleset_defined) {
+        std::fprintf(stderr, "[wrapper] ERROR: ruleset must be 'en' or a --ruleset-context, got '%s'\n",
+                cfg.ruleset.c_str());
         return 1;
     }
     std::fprintf(stderr, "[wrapper] ruleset validated: %s\n", cfg.ruleset.c_str());
@@ -251,7 +509,10 @@ int main(int argc, char** argv) {
     // Determine which lexicon to use
     std::string lexicon_path;
     std::string lexicon_type;
-    if (cfg.use_lexicon == "dawg" && !cfg.dawg_path.empty()) {
+    if (!cfg.mapped_gaddag_path.empty()) {
+        lexicon_path = cfg.mapped_gaddag_path;
+        lexicon_type = "GADDAG";
+    } else if (cfg.use_lexicon == "dawg" && !cfg.dawg_path.empty()) {
         lexicon_path = cfg.dawg_path;
         lexicon_type = "DAWG";
     } else if (cfg.use_lexicon == "gaddag" && !cfg.gaddag_path.empty()) {
@@ -310,6 +571,21 @@ int main(int argc, char** argv) {
         }
     }
 
+    // Keep to one NUMA node: threads started from here on run on its CPUs,
+    // so Quackle's tables are first touched in its memory and the mapped
+    // tables are copied there. One wrapper per node replicates the lexicon.
+    if (cfg.residency.numa_node >= 0) {
+        std::string numa_error;
+        if (!wrapper::pin_to_numa_node(cfg.residency.numa_node, numa_error)) {
+            std::fprintf(stderr, "[wrapper] ERROR: --numa-node %d: %s\n", cfg.residency.numa_node, numa_error.c_str());
+            return 1;
+        }
+    }
+    if (cfg.residency.any()) {
+        std::fprintf(stderr, "[wrapper] residency huge_pages=%d mlock=%d numa_node=%d\n", (int)cfg.residency.huge_pages,
+                (int)cfg.residency.lock, cfg.residency.numa_node);
+    }
+
     // Initialize Quackle environment (once)
     if (!QUACKLE_DATAMANAGER_EXISTS) {
         new Quackle::DataManager();
@@ -383,81 +659,99 @@ int main(int argc, char** argv) {
     bool lexicon_loaded = false;
     auto t0_load = std::chrono::steady_clock::now();
     
-    try {
-        // Check file exists and is readable
-        if (!std::filesystem::exists(lexicon_path)) {
-            std::fprintf(stderr, "[wrapper] ERROR: %s file not found: %s\n", lexicon_type.c_str(), lexicon_path.c_str());
-            return 2;
+    // A mapped GADDAG replaces Quackle's loader: mapping it is all there is
+    // to do, and the wrapper generator serves every request from it
+    // (published, so reload_lexicon can replace it under running requests)
+    wrapper::Published<wrapper::MappedGraph> mapped_graph;
+    if (!cfg.mapped_gaddag_path.empty()) {
+        auto graph = std::make_shared<wrapper::MappedGraph>();
+        std::string map_error;
+        if (!graph->open(lexicon_path, map_error)) {
+            std::fprintf(stderr, "[wrapper] ✗ mapped GADDAG failed: %s: %s\n", lexicon_path.c_str(), map_error.c_str());
+            return 4;
         }
+        graph->apply_residency(cfg.residency);
+        std::fprintf(stderr, "[wrapper] ✓ mapped GADDAG: %zu nodes, %zu bytes\n", graph->node_count(),
+                graph->bytes());
+        mapped_graph.publish(std::move(graph));
+        lexicon_loaded = true;
+    } else {
+        try {
+            // Check file exists and is readable
+            if (!std::filesystem::exists(lexicon_path)) {
+                std::fprintf(stderr, "[wrapper] ERROR: %s file not found: %s\n", lexicon_type.c_str(), lexicon_path.c_str());
+                return 2;
+            }
         
-        std::ifstream test_file(lexicon_path, std::ios::binary);
-        if (!test_file.good()) {
-            std::fprintf(stderr, "[wrapper] ERROR: cannot open %s file: %s\n", lexicon_type.c_str(), lexicon_path.c_str());
-            return 3;
-        }
+            std::ifstream test_file(lexicon_path, std::ios::binary);
+            if (!test_file.good()) {
+                std::fprintf(stderr, "[wrapper] ERROR: cannot open %s file: %s\n", lexicon_type.c_str(), lexicon_path.c_str());
+                return 3;
+            }
         
-        // Robust lexicon loading with detailed diagnostics
-        std::fprintf(stderr, "[wrapper] Attempting %s load: %s\n", lexicon_type.c_str(), lexicon_path.c_str());
+            // Robust lexicon loading with detailed diagnostics
+            std::fprintf(stderr, "[wrapper] Attempting %s load: %s\n", lexicon_type.c_str(), lexicon_path.c_str());
         
-        // Pre-load diagnostics
-        std::error_code ec;
-        auto file_size = std::filesystem::file_size(lexicon_path, ec);
-        if (ec) {
-            std::fprintf(stderr, "[wrapper] FATAL: Cannot get file size: %s\n", ec.message().c_str());
-            return 2;
-        }
+            // Pre-load diagnostics
+            std::error_code ec;
+            auto file_size = std::filesystem::file_size(lexicon_path, ec);
+            if (ec) {
+                std::fprintf(stderr, "[wrapper] FATAL: Cannot get file size: %s\n", ec.message().c_str());
+                return 2;
+            }
         
-        std::fprintf(stderr, "[wrapper] %s file size: %zu bytes\n", lexicon_type.c_str(), file_size);
+            std::fprintf(stderr, "[wrapper] %s file size: %zu bytes\n", lexicon_type.c_str(), file_size);
         
-        // Show first 16 bytes for format validation and alphabet info
-        std::ifstream lexicon_file(lexicon_path, std::ios::binary);
-        if (lexicon_file) {
-            char header[16] = {0};
-            lexicon_file.read(header, 16);
-            std::fprintf(stderr, "[wrapper] %s header (first 16 bytes): ", lexicon_type.c_str());
-            for (int i = 0; i < 16; i++) {
-                std::fprintf(stderr, "%02x ", (unsigned char)header[i]);
+            // Show first 16 bytes for format validation and alphabet info
+            std::ifstream lexicon_file(lexicon_path, std::ios::binary);
+            if (lexicon_file) {
+                char header[16] = {0};
+                lexicon_file.read(header, 16);
+                std::fprintf(stderr, "[wrapper] %s header (first 16 bytes): ", lexicon_type.c_str());
+                for (int i = 0; i < 16; i++) {
+                    std::fprintf(stderr, "%02x ", (unsigned char)header[i]);
+                }
+                std::fprintf(stderr, "\n");
+                lexicon_file.close();
             }
-            std::fprintf(stderr, "\n");
-            lexicon_file.close();
-        }
         
-        // Log alphabet information
-        std::string alphabet_path = std::getenv("QUACKLE_ALPHABET") ? std::getenv("QUACKLE_ALPHABET") : "";
-        if (!alphabet_path.empty()) {
-            std::fprintf(stderr, "[wrapper] Alphabet file: %s\n", alphabet_path.c_str());
-            if (std::filesystem::exists(alphabet_path)) {
-                std::fprintf(stderr, "[wrapper] Alphabet file exists and accessible\n");
+            // Log alphabet information
+            std::string alphabet_path = std::getenv("QUACKLE_ALPHABET") ? std::getenv("QUACKLE_ALPHABET") : "";
+            if (!alphabet_path.empty()) {
+                std::fprintf(stderr, "[wrapper] Alphabet file: %s\n", alphabet_path.c_str());
+                if (std::filesystem::exists(alphabet_path)) {
+                    std::fprintf(stderr, "[wrapper] Alphabet file exists and accessible\n");
+                } else {
+                    std::fprintf(stderr, "[wrapper] WARNING: Alphabet file not found\n");
+                }
             } else {
-                std::fprintf(stderr, "[wrapper] WARNING: Alphabet file not found\n");
+                std::fprintf(stderr, "[wrapper] Using default English alphabet (no QUACKLE_ALPHABET env)\n");
             }
-        } else {
-            std::fprintf(stderr, "[wrapper] Using default English alphabet (no QUACKLE_ALPHABET env)\n");
-        }
         
-        // Load lexicon (no fallbacks allowed)
-        try {
-            if (lexicon_type == "GADDAG") {
-                lexParams->loadGaddag(lexicon_path);
-            } else {
-                lexParams->loadDawg(lexicon_path);
+            // Load lexicon (no fallbacks allowed)
+            try {
+                if (lexicon_type == "GADDAG") {
+                    lexParams->loadGaddag(lexicon_path);
+                } else {
+                    lexParams->loadDawg(lexicon_path);
+                }
+                std::fprintf(stderr, "[wrapper] ✓ %s loaded successfully\n", lexicon_type.c_str());
+                lexicon_loaded = true;
+            } catch (const std::exception& e) {
+                std::fprintf(stderr, "[wrapper] ✗ %s loading failed: %s\n", lexicon_type.c_str(), e.what());
+                return 4;
+            } catch (...) {
+                std::fprintf(stderr, "[wrapper] ✗ %s loading failed: unknown exception\n", lexicon_type.c_str());
+                return 5;
             }
-            std::fprintf(stderr, "[wrapper] ✓ %s loaded successfully\n", lexicon_type.c_str());
-            lexicon_loaded = true;
+        
         } catch (const std::exception& e) {
-            std::fprintf(stderr, "[wrapper] ✗ %s loading failed: %s\n", lexicon_type.c_str(), e.what());
-            return 4;
+            std::fprintf(stderr, "[wrapper] FATAL: File system error: %s\n", e.what());
+            return 3;
         } catch (...) {
-            std::fprintf(stderr, "[wrapper] ✗ %s loading failed: unknown exception\n", lexicon_type.c_str());
-            return 5;
+            std::fprintf(stderr, "[wrapper] FATAL: Unknown error during file checks\n");
+            return 6;
         }
-        
-    } catch (const std::exception& e) {
-        std::fprintf(stderr, "[wrapper] FATAL: File system error: %s\n", e.what());
-        return 3;
-    } catch (...) {
-        std::fprintf(stderr, "[wrapper] FATAL: Unknown error during file checks\n");
-        return 6;
     }
     auto ms_load = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - t0_load).count();
     std::fprintf(stderr, "[wrapper] lexicon_loaded ms=%lld\n", static_cast<long long>(ms_load));
@@ -478,6 +772,100 @@ int main(int argc, char** argv) {
         std::fprintf(stderr, "[wrapper] No strategy parameters found\n");
     }
 
+    // Wrapper generator: rules snapshot and intra-request worker pool
+    const wrapper::Rules gen_rules = wrapper::rules_from_quackle();
+    // Other rulesets, each with its own rules, lexicon and leaves; requests
+    // pick one with "ruleset" and run on the wrapper generator
+    std::unordered_map<std::string, std::unique_ptr<wrapper::RulesetContext>> rulesets;
+    for (const std::string &spec : cfg.rulesets) {
+        auto context = std::make_unique<wrapper::RulesetContext>();
+        std::string ruleset_error;
+        if (!wrapper::load_ruleset(spec, gen_rules, cfg.residency, *context, ruleset_error)) {
+            std::fprintf(stderr, "[wrapper] ERROR: bad --ruleset-context '%s': %s\n", spec.c_str(),
+                    ruleset_error.c_str());
+            return 1;
+        }
+        if (context->name == "en" || rulesets.count(context->name)) {
+            std::fprintf(stderr, "[wrapper] ERROR: ruleset '%s' defined twice\n", context->name.c_str());
+            return 1;
+        }
+        std::fprintf(stderr, "[wrapper] ruleset %s: rack=%d bingo=%d lexicon=%zu bytes leaves=%s\n",
+                context->name.c_str(), context->rules.rack_size, context->rules.bingo_bonus,
+                context->graph->bytes(), context->leaves.loaded() ? "mapped" : "none");
+        rulesets.emplace(context->name, std::move(context));
+    }
+    int gen_threads = cfg.gen_threads > 0 ? cfg.gen_threads : static_cast<int>(std::thread::hardware_concurrency());
+    if (gen_threads < 1) gen_threads = 1;
+    auto gen_pool = std::make_unique<wrapper::WorkPool>(gen_threads);
+    // Per-thread scratch for the wrapper generator, reused across requests:
+    // heaps, key sets, line bounds and the request arena, the board and the
+    // reply text
+    thread_local wrapper::GenWorkspace gen_workspace;
+    thread_local wrapper::SharedBoard gen_board;
+    thread_local std::string gen_reply;
+    std::fprintf(stderr, "[wrapper] generator pool threads=%d\n", gen_threads);
+    // Full move lists behind compute "paginate" cursors, served by moves_page
+    wrapper::MoveStore move_store(static_cast<size_t>(std::max(cfg.page_entries, 0)),
+                                  static_cast<size_t>(std::max(cfg.page_moves, 0)),
+                                  std::chrono::milliseconds(std::max(cfg.page_ttl_ms, 0)));
+    // Precomputed leave values; without them leaves go through Quackle's evaluator
+    wrapper::MappedLeaves mapped_leaves;
+    if (!cfg.leaves_path.empty()) {
+        std::string leaves_error;
+        if (mapped_leaves.open(cfg.leaves_path, leaves_error)) {
+            mapped_leaves.apply_residency(cfg.residency);
+            std::fprintf(stderr, "[wrapper] leave table mapped: %s (%zu bytes)\n",
+                    cfg.leaves_path.c_str(), mapped_leaves.bytes());
+        } else {
+            std::fprintf(stderr, "[wrapper] leave table not used: %s: %s\n",
+                    cfg.leaves_path.c_str(), leaves_error.c_str());
+        }
+    }
+    auto mapped_leave_value = [&mapped_leaves](const wrapper::RackCounts &leave) {
+        return mapped_leaves.value(leave);
+    };
+    // Further lexica, mapped on first request and dropped LRU over the cap
+    wrapper::LexiconRegistry lexica(static_cast<size_t>(std::max(cfg.lexica_cap_mb, 0)) << 20, cfg.residency);
+    for (const std::string &spec : cfg.lexica) {
+        const size_t eq = spec.find('=');
+        if (eq == std::string::npos || !lexica.add(spec.substr(0, eq), spec.substr(eq + 1))) {
+            std::fprintf(stderr, "[wrapper] ERROR: bad --lexicon '%s' (want unique name=path)\n", spec.c_str());
+            return 1;
+        }
+        std::fprintf(stderr, "[wrapper] lexicon registered: %s\n", spec.c_str());
+    }
+
+    // Lexicon reloads: one in flight at most, published at the top of the loop
+    LexiconReload reload;
+    reload.residency = cfg.residency;
+    int lexicon_generation = 1;
+    std::string last_reload_error;
+    auto finish_reload = [&]() {
+        if (!reload.worker.joinable() || !reload.done.load(std::memory_order_acquire)) return;
+        reload.worker.join();
+        if (!reload.error.empty()) {
+            std::fprintf(stderr, "[reload] ✗ %s %s: %s\n", reload.type.c_str(), reload.path.c_str(),
+                    reload.error.c_str());
+            last_reload_error = reload.path + ": " + reload.error;
+            return;
+        }
+        if (reload.mapped) {
+            mapped_graph.publish(std::move(reload.mapped));
+        } else {
+            // Quackle frees the previous parameters; nothing walks them between requests
+            QUACKLE_DATAMANAGER->setLexiconParameters(reload.params);
+            reload.params = nullptr;
+            mapped_graph.publish(nullptr);
+        }
+        lexicon_path = reload.path;
+        lexicon_type = reload.type == "DAWG" ? "DAWG" : "GADDAG";
+        lexicon_loaded = true;
+        ++lexicon_generation;
+        last_reload_error.clear();
+        std::fprintf(stderr, "[reload] ✓ generation=%d %s %s\n", lexicon_generation, reload.type.c_str(),
+                reload.path.c_str());
+    };
+
     std::fprintf(stderr, "[wrapper] Setting up I/O...\n");
     std::ios::sync_with_stdio(false);
     std::cin.tie(nullptr);
@@ -497,6 +885,7 @@ int main(int argc, char** argv) {
         }
         std::fprintf(stderr, "[loop] got line len=%zu: %.*s\n", line.size(),
                 (int)std::min<size_t>(line.size(), 200), line.c_str());
+        finish_reload();
 
         if (line.empty()) {
             std::fprintf(stderr, "[loop] empty line -> continue\n");
@@ -534,6 +923,21 @@ int main(int argc, char** argv) {
                 json out;
                 out["lexicon_ok"] = lexicon_loaded;
                 out["lexicon_type"] = lexicon_type;
+                out["mapped"] = mapped_graph.acquire() != nullptr;
+                out["generation"] = lexicon_generation;
+                out["reload_pending"] = reload.worker.joinable();
+                out["last_reload_error"] = last_reload_error.empty() ? json(nullptr) : json(last_reload_error);
+                json named = json::array();
+                for (const auto &lex : lexica.status()) {
+                    named.push_back({ {"name", lex.name}, {"path", lex.path}, {"resident", lex.resident},
+                                      {"bytes", lex.bytes}, {"in_memory_bytes", lex.in_memory},
+                                      {"huge_page_bytes", lex.huge_pages}, {"locked", lex.locked},
+                                      {"loads", lex.loads}, {"uses", lex.uses},
+                                      {"error", lex.error.empty() ? json(nullptr) : json(lex.error)} });
+                }
+                out["lexica"] = named;
+                out["lexica_resident_bytes"] = lexica.resident_bytes();
+                out["lexica_cap_bytes"] = lexica.cap_bytes();
                 out["lexicon_path"] = lexicon_path;
                 struct stat st{};
                 long long size = -1;
@@ -542,10 +946,96 @@ int main(int argc, char** argv) {
                 std::string alphabet_path2 = std::getenv("QUACKLE_ALPHABET") ? std::getenv("QUACKLE_ALPHABET") : "";
                 out["alphabet"] = alphabet_path2.empty() ? "default_english" : alphabet_path2;
                 out["ruleset"] = cfg.ruleset;
+                json contexts = json::array();
+                for (const auto &entry : rulesets) {
+                    const wrapper::RulesetContext &rc = *entry.second;
+                    contexts.push_back({ {"name", rc.name}, {"rack_size", rc.rules.rack_size},
+                                         {"bingo_bonus", rc.rules.bingo_bonus}, {"lexicon_bytes", rc.graph->bytes()},
+                                         {"leaves", rc.leaves.loaded()} });
+                }
+                out["rulesets"] = contexts;
+                // Where the mapped tables live (--huge-pages, --mlock, --numa-node)
+                json tables = json::array();
+                if (auto graph = mapped_graph.acquire()) tables.push_back(residency_json("lexicon", *graph));
+                if (mapped_leaves.loaded()) tables.push_back(residency_json("leaves", mapped_leaves));
+                for (const auto &entry : rulesets) {
+                    tables.push_back(residency_json("ruleset:" + entry.first, *entry.second->graph));
+                    if (entry.second->leaves.loaded())
+                        tables.push_back(residency_json("ruleset:" + entry.first + ":leaves", entry.second->leaves));
+                }
+                struct rusage usage{};
+                ::getrusage(RUSAGE_SELF, &usage);
+                out["residency"] = { {"huge_pages", cfg.residency.huge_pages}, {"mlock", cfg.residency.lock},
+                                     {"numa_node", cfg.residency.numa_node},
+                                     {"major_faults", static_cast<long long>(usage.ru_majflt)}, {"tables", tables} };
                 std::cout << out.dump() << "\n";
                 std::cout.flush();
                 continue;
             }
+            // Swaps the lexicon without a restart: replies once the load has
+            // started; probe_lexicon shows the generation it lands as
+            if (op == "reload_lexicon") {
+                const std::string path = in.value("path", std::string());
+                const std::string type = to_upper(in.value("type",
+                        mapped_graph.acquire() ? std::string("mapped") : lexicon_type));
+                if (path.empty() || (type != "GADDAG" && type != "DAWG" && type != "MAPPED")) {
+                    json out = { {"error", "invalid_input"},
+                                 {"reason", "reload_lexicon needs a path and a type of gaddag, dawg or mapped"} };
+                    std::cout << out.dump() << "\n"; std::cout.flush();
+                    continue;
+                }
+                if (reload.worker.joinable()) {
+                    json out = { {"error", "reload_in_progress"}, {"path", reload.path} };
+                    std::cout << out.dump() << "\n"; std::cout.flush();
+                    continue;
+                }
+                reload.path = path;
+                reload.type = type;
+                reload.error.clear();
+                reload.done.store(false, std::memory_order_relaxed);
+                reload.worker = std::thread(load_lexicon, std::ref(reload));
+                std::fprintf(stderr, "[reload] loading %s %s\n", type.c_str(), path.c_str());
+                json out = { {"generation", lexicon_generation + 1}, {"path", path}, {"reload", "started"},
+                             {"type", type} };
+                std::cout << out.dump() << "\n"; std::cout.flush();
+                continue;
+            }
+            // Further pages of a list kept by a paginated compute; nothing is
+            // regenerated
+            if (op == "moves_page") {
+                const std::string cursor = in.value("cursor", std::string());
+                const long long offset = in.value("offset", 0LL);
+                const long long limit = std::min(in.value("limit", 10LL), kMaxPageSize);
+                if (cursor.empty() || offset < 0 || limit < 1) {
+                    json out = { {"moves", json::array()}, {"error", "invalid_input"},
+                                 {"reason", "moves_page needs a cursor, offset >= 0 and limit >= 1"} };
+                    std::cout << out.dump() << "\n"; std::cout.flush();
+                    continue;
+                }
+                const auto *moves = move_store.get(cursor);
+                if (!moves) {
+                    json out = { {"moves", json::array()}, {"error", "cursor_expired"} };
+                    std::cout << out.dump() << "\n"; std::cout.flush();
+                    continue;
+                }
+                const size_t total = moves->size();
+                const size_t begin = std::min(static_cast<size_t>(offset), total);
+                const size_t end = std::min(begin + static_cast<size_t>(limit), total);
+                gen_reply.clear();
+                gen_reply += "{\"cursor\":\"";
+                gen_reply += cursor;
+                gen_reply += "\",\"moves\":[";
+                for (size_t i = begin; i < end; ++i) {
+                    if (i > begin) gen_reply.push_back(',');
+                    append_candidate_json(gen_reply, (*moves)[i]);
+                }
+                gen_reply += "],\"next\":";
+                gen_reply += end < total ? std::to_string(end) : std::string("null");
+                gen_reply += ",\"offset\":" + std::to_string(begin) + ",\"total\":" + std::to_string(total) + "}\n";
+                std::cout << gen_reply;
+                std::cout.flush();
+                continue;
+            }
             // no test_move op; only compute is supported
             
             if (op == "compute" || op == "move") {
@@ -590,14 +1080,15 @@ int main(int argc, char** argv) {
         }
 
         const auto &board_in = in["board"];
-        if (!board_in.contains("cells") || !board_in["cells"].is_array() || board_in["cells"].size() != 15) {
-            std::fprintf(stderr, "[compute] invalid: board.cells must be array of 15 rows\n");
+        if (!board_in.contains("cells") || !board_in["cells"].is_array() ||
+            board_in["cells"].size() != static_cast<size_t>(wrapper::kBoardDim)) {
+            std::fprintf(stderr, "[compute] invalid: board.cells must be array of %d rows\n", wrapper::kBoardDim);
             json out = { {"moves", json::array()}, {"error", "invalid_board"} };
             std::cout << out.dump() << "\n"; std::cout.flush();
             continue;
         }
         for (const auto &row : board_in["cells"]) {
-            if (!row.is_array() || row.size() != 15) {
+            if (!row.is_array() || row.size() != static_cast<size_t>(wrapper::kBoardDim)) {
                 json out = { {"moves", json::array()}, {"error", "invalid_board"} };
                 std::cout << out.dump() << "\n"; std::cout.flush();
                 continue;
@@ -637,11 +1128,197 @@ int main(int argc, char** argv) {
             continue;
         }
 
-        // Build position
-        Quackle::PlayerList players;
-        players.push_back( Quackle::Player("A", 1, 0) );  // HumanPlayerType = 1
-        players.push_back( Quackle::Player("B", 1, 1) );  // HumanPlayerType = 1
-        Quackle::GamePosition pos(players);
+        // Ranking: "equity" (default) or "score". Score ranking never reads
+        // leave values, and only the wrapper generator can skip them.
+        const std::string rank_by = in.value("rank_by", std::string("equity"));
+        if (rank_by != "equity" && rank_by != "score") {
+            json out = { {"moves", json::array()}, {"error", "invalid_input"}, {"reason", "rank_by must be equity or score"} };
+            std::cout << out.dump() << "\n"; std::cout.flush();
+            continue;
+        }
+        const bool rank_by_score = rank_by == "score";
+        wrapper::GenConstraints constraints;
+        if (in.contains("constraints")) {
+            try {
+                parse_constraints(in["constraints"], constraints);
+            } catch (const std::exception &e) {
+                json out = { {"moves", json::array()}, {"error", "invalid_input"}, {"reason", e.what()} };
+                std::cout << out.dump() << "\n"; std::cout.flush();
+                continue;
+            }
+        }
+        const bool constrained = constraints.any();
+        // Exchanges need a full rack's worth of tiles in the bag; an empty
+        // "bag" means the caller did not say
+        const std::string bag = in.value("bag", std::string());
+        // Ruleset: "en" is Quackle's setup; any other is a preloaded context
+        const std::string ruleset = in.value("ruleset", cfg.ruleset);
+        const wrapper::RulesetContext *context = nullptr;
+        if (ruleset != "en") {
+            auto it = rulesets.find(ruleset);
+            if (it == rulesets.end()) {
+                json out = { {"moves", json::array()}, {"error", "unknown_ruleset"}, {"reason", ruleset} };
+                std::cout << out.dump() << "\n"; std::cout.flush();
+                continue;
+            }
+            context = it->second.get();
+        }
+        const wrapper::Rules &rules = context ? context->rules : gen_rules;
+        // The leave table holds every sub-multiset of the rack, so its size
+        // is exponential in the rack length: nothing longer than a rack gets
+        // that far
+        if (static_cast<int>(rackStr.size()) > rules.rack_size) {
+            json out = { {"moves", json::array()}, {"error", "invalid_input"},
+                         {"reason", "rack has " + std::to_string(rackStr.size()) + " tiles (max " +
+                                    std::to_string(rules.rack_size) + ")"} };
+            std::cout << out.dump() << "\n"; std::cout.flush();
+            continue;
+        }
+        const bool exchange_allowed = bag.empty() || static_cast<int>(bag.size()) >= rules.rack_size;
+        // A named lexicon comes from the registry, otherwise the default one.
+        // The snapshot keeps the graph mapped even if a reload or an eviction
+        // lands meanwhile.
+        const std::string lexicon_name = in.value("lexicon", std::string());
+        std::shared_ptr<const wrapper::MappedGraph> mapped;
+        if (!lexicon_name.empty()) {
+            std::string lexicon_error;
+            mapped = lexica.acquire(lexicon_name, lexicon_error);
+            if (!mapped) {
+                const char *error = lexica.contains(lexicon_name) ? "lexicon_unavailable" : "unknown_lexicon";
+                json out = { {"moves", json::array()}, {"error", error}, {"reason", lexicon_error} };
+                std::cout << out.dump() << "\n"; std::cout.flush();
+                continue;
+            }
+        } else {
+            mapped = context ? context->graph : mapped_graph.acquire();
+        }
+
+        // Wrapper generator: parallel mode splits it by line across the pool;
+        // score ranking and constraints run it on this thread unless parallel
+        // is also set. It also takes every opening it can: the centre rule is
+        // built into its anchors, so top_n is filled rather than post-filtered.
+        const bool parallel = in.value("parallel", false);
+        const bool wrapper_opening = is_board_empty && lexicon_type == "GADDAG";
+        // Pagination keeps every play, sorted, and returns the first top_n
+        // with a cursor for moves_page
+        const bool paginate = in.value("paginate", false);
+        // A mapped lexicon was never loaded into Quackle: everything goes here
+        if (mapped || parallel || rank_by_score || constrained || paginate || wrapper_opening) {
+            if (!mapped && lexicon_type != "GADDAG") {
+                const char *error = parallel ? "parallel_requires_gaddag"
+                                  : rank_by_score ? "rank_by_score_requires_gaddag"
+                                  : constrained ? "constraints_require_gaddag"
+                                                : "paginate_requires_gaddag";
+                json out = { {"moves", json::array()}, {"error", error} };
+                std::cout << out.dump() << "\n"; std::cout.flush();
+                continue;
+            }
+            auto t_parallel_start = std::chrono::steady_clock::now();
+            // Reuses the thread's board unless a snapshot of it is still held
+            wrapper::BoardState &board_state = gen_board.mutate();
+            fill_board_state(board_in["cells"], board_state);
+            const wrapper::RackCounts rack_counts = wrapper::rack_from_string(rackStr);
+            if (context && !context_letters_ok(*context, rack_counts, board_state)) {
+                json out = { {"moves", json::array()}, {"error", "invalid_input"},
+                             {"reason", "letter or blank count outside the " + ruleset + " alphabet"} };
+                std::cout << out.dump() << "\n"; std::cout.flush();
+                continue;
+            }
+            // Score ranking leaves the table empty: no leave is ever evaluated.
+            // A context without a leave table ranks by score plus a zero leave.
+            wrapper::LeaveTable leaves(gen_workspace.arena.resource());
+            if (!rank_by_score) {
+                if (context) {
+                    leaves.build(rack_counts, [context](const wrapper::RackCounts &leave) {
+                        return context->leaves.loaded() ? context->leaves.value(leave) : 0.0;
+                    });
+                } else if (mapped_leaves.loaded()) {
+                    leaves.build(rack_counts, mapped_leave_value);
+                } else {
+                    leaves.build(rack_counts, wrapper::quackle_leave_value);
+                }
+            }
+            // Bounded top-K unless the caller explicitly asks for every play
+            wrapper::GenOptions gen_options;
+            gen_options.top_n = in.value("all_plays", false) || paginate ? 0 : top_n;
+            gen_options.prune = in.value("prune", false);
+            gen_options.rank_by = rank_by_score ? wrapper::RankBy::Score : wrapper::RankBy::Equity;
+            gen_options.constraints = constraints;
+            wrapper::WorkPool *pool = parallel ? gen_pool.get() : nullptr;
+            const int threads = pool ? pool->size() : 1;
+            // A mapped lexicon is walked in place; otherwise Quackle's loaded GADDAG
+            auto generate = [&](const auto &graph) {
+                board_state.prepare(graph, rules);
+                return wrapper::generate_moves(graph, *gen_board, rules, rack_counts, leaves, pool,
+                                               gen_options, gen_workspace);
+            };
+            const auto best = mapped ? generate(*mapped)
+                                     : generate(wrapper::QuackleGaddag(
+                                           QUACKLE_DATAMANAGER->lexiconParameters()->gaddagRoot()));
+            auto elapsed_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::steady_clock::now() - t_parallel_start).count();
+            std::fprintf(stderr, "[wrapper] wrapper generation: moves=%zu threads=%d rank_by=%s ms=%lld\n",
+                    best.size(), threads, rank_by.c_str(), static_cast<long long>(elapsed_ms));
+
+            wrapper::Exchange exchange;
+            // Without leave values every exchange is worth 0: none is offered
+            const bool exchange_found = !rank_by_score && exchange_allowed &&
+                                        (!context || context->leaves.loaded()) &&
+                                        wrapper::best_exchange(rack_counts, leaves, exchange);
+
+            // A paginated reply carries the first top_n; the whole list stays
+            // behind the cursor. A list over the store's budget gets no cursor.
+            const size_t returned = paginate ? std::min(best.size(), static_cast<size_t>(top_n)) : best.size();
+            std::string cursor;
+            if (paginate) {
+                cursor = move_store.put(std::vector<wrapper::Candidate>(best.begin(), best.end()));
+                if (cursor.empty())
+                    std::fprintf(stderr, "[wrapper] paginate: %zu moves exceed the page store, no cursor\n",
+                            best.size());
+            }
+
+            gen_reply.clear();
+            gen_reply += "{";
+            if (!cursor.empty()) {
+                char cursor_buf[128];
+                std::snprintf(cursor_buf, sizeof(cursor_buf),
+                              "\"cursor\":{\"expires_ms\":%d,\"id\":\"%s\",\"next\":", cfg.page_ttl_ms,
+                              cursor.c_str());
+                gen_reply += cursor_buf;
+                gen_reply += returned < best.size() ? std::to_string(returned) : std::string("null");
+                gen_reply += ",\"total\":" + std::to_string(best.size()) + "},";
+            }
+            if (exchange_found) {
+                gen_reply += "\"exchange\":";
+                append_exchange_json(gen_reply, exchange, best.empty() || exchange.equity > best[0].equity);
+                gen_reply += ",";
+            }
+            gen_reply += "\"meta\":{";
+            char meta_buf[384];
+            std::snprintf(meta_buf, sizeof(meta_buf),
+                          "\"board_empty\":%s,\"constrained\":%s,\"generator\":\"%s\",\"lexicon\":\"%s\","
+                          "\"moves_returned\":%zu,\"rank_by\":\"%s\",\"ruleset\":\"%s\",\"threads\":%d,"
+                          "\"time_ms\":%lld,\"truncated\":false},\"moves\":[",
+                          is_board_empty ? "true" : "false", constrained ? "true" : "false",
+                          parallel ? "parallel" : "wrapper", lexicon_name.empty() ? "default" : lexicon_name.c_str(),
+                          returned, rank_by.c_str(), context ? context->name.c_str() : "en", threads,
+                          static_cast<long long>(elapsed_ms));
+            gen_reply += meta_buf;
+            for (size_t i = 0; i < returned; ++i) {
+                if (i) gen_reply.push_back(',');
+                append_candidate_json(gen_reply, best[i]);
+            }
+            gen_reply += "]}\n";
+            std::cout << gen_reply;
+            std::cout.flush();
+            gen_workspace.arena.rewind();
+            continue;
+        }
+
+        // Build position: long-lived per thread, reset below for this request
+        QuackleContext &qctx = quackle_context();
+        const Quackle::PlayerList &players = qctx.players;
+        Quackle::GamePosition &pos = qctx.pos;
         
         // Verify players are properly initialized
         std::fprintf(stderr, "[wrapper] players count: %zu\n", players.size());
@@ -669,11 +1346,11 @@ int main(int argc, char** argv) {
             std::fprintf(stderr, "[wrapper] ERROR: Cannot access currentPlayer(): %s\n", e.what());
         }
         
-        // CRITICAL FIX: Use setPosition() instead of copy constructor to avoid iterator issues
+        // CRITICAL FIX: Use setPosition() instead of copy constructor to avoid iterator issues.
+        // `pos` keeps an empty board and only carries rack and bag; the request's
+        // tiles go straight onto the generator's own board (see below), so the
+        // board is built once instead of built here and then copied.
         std::fprintf(stderr, "[wrapper] using setPosition() to avoid copy constructor issues\n");
-        
-        Quackle::Board &board = pos.underlyingBoardReference();
-        board.prepareEmptyBoard();
 
         // Set rack - SEPARATE blanks from letters to avoid OOB in counts
         Quackle::Rack rack;
@@ -727,13 +1404,17 @@ int main(int argc, char** argv) {
         pos.setCurrentPlayerRack(rack, false);
 
         // Bag (optional, not fully modeled here)
-        pos.setBag(Quackle::Bag());
+        pos.setBag(qctx.bag);
+
+        Quackle::Generator &gen = qctx.gen;
+        gen.setPosition(pos);
+        const Quackle::Board &board = gen.position().board();
 
         // Place existing tiles from 15x15 matrix with validation
         int board_tiles_placed = 0;
-        for (int r = 0; r < 15; ++r) {
+        for (int r = 0; r < wrapper::kBoardDim; ++r) {
             const auto &row = board_in["cells"][r];
-            for (int c = 0; c < 15; ++c) {
+            for (int c = 0; c < wrapper::kBoardDim; ++c) {
                 std::string cell = "";
                 try { cell = row[c].get<std::string>(); } catch (...) { cell.clear(); }
                 if (cell.empty()) continue;
@@ -752,7 +1433,7 @@ int main(int argc, char** argv) {
                 std::string singleStr(1, ch);
                 Quackle::LetterString single = alphabet->encode(singleStr);
                 Quackle::Move m = Quackle::Move::createPlaceMove(r, c, true /*horizontal unused for single*/ , single);
-                board.makeMove(m);
+                gen.makeMove(m, false /* crosses computed once below */);
                 board_tiles_placed++;
             }
         }
@@ -760,13 +1441,13 @@ int main(int argc, char** argv) {
 
         // Hard timebox via async (also include heavy cross computation here)
         auto t_compute_start = std::chrono::steady_clock::now();
+        double best_move_equity = 0.0;
+        bool have_best_move = false;
         auto worker = [&]() {
             // REMOVED: Fast path fallback to force gen.kibitz() call and catch segfault
             // if (is_board_empty) { ... }
 
-            Quackle::Generator gen;
-            gen.setPosition(pos);
-            
+
             // DEBUG: Verify the position has the correct rack
             const Quackle::Rack& currentRack = pos.currentPlayer().rack();
             std::fprintf(stderr, "[wrapper] DEBUG: position rack: ");
@@ -807,7 +1488,7 @@ int main(int argc, char** argv) {
             std::fprintf(stderr, "[wrapper] board empty: %s\n", is_board_empty ? "YES" : "NO");
             
             // DEBUG: Log board dimensions and center
-            std::fprintf(stderr, "[wrapper] DEBUG: Board dimensions: %dx%d\n", 15, 15);
+            std::fprintf(stderr, "[wrapper] DEBUG: Board dimensions: %dx%d\n", wrapper::kBoardDim, wrapper::kBoardDim);
             std::fprintf(stderr, "[wrapper] DEBUG: Expected center square: (7, 7)\n");
             
             if (is_board_empty) {
@@ -818,14 +1499,14 @@ int main(int argc, char** argv) {
             } else {
                 // Count anchors on non-empty board
                 int anchor_count = 0;
-                for (int r = 0; r < 15; ++r) {
-                    for (int c = 0; c < 15; ++c) {
+                for (int r = 0; r < wrapper::kBoardDim; ++r) {
+                    for (int c = 0; c < wrapper::kBoardDim; ++c) {
                         if (board.letter(r, c) != 0) { // non-empty cell
                             // Check if this cell is an anchor (adjacent to empty cells)
                             bool is_anchor = false;
                             for (int dr = -1; dr <= 1; dr += 2) {
                                 int nr = r + dr;
-                                if (nr >= 0 && nr < 15 && board.letter(nr, c) == 0) {
+                                if (nr >= 0 && nr < wrapper::kBoardDim && board.letter(nr, c) == 0) {
                                     is_anchor = true;
                                     break;
                                 }
@@ -833,7 +1514,7 @@ int main(int argc, char** argv) {
                             if (!is_anchor) {
                                 for (int dc = -1; dc <= 1; dc += 2) {
                                     int nc = c + dc;
-                                    if (nc >= 0 && nc < 15 && board.letter(r, nc) == 0) {
+                                    if (nc >= 0 && nc < wrapper::kBoardDim && board.letter(r, nc) == 0) {
                                         is_anchor = true;
                                         break;
                                     }
@@ -891,9 +1572,9 @@ int main(int argc, char** argv) {
             
             // Log board tiles (normalized and validated)
             std::fprintf(stderr, "[telemetry] === BOARD TILES ===\n");
-            for (int r = 0; r < 15; ++r) {
+            for (int r = 0; r < wrapper::kBoardDim; ++r) {
                 const auto &row = board_in["cells"][r];
-                for (int c = 0; c < 15; ++c) {
+                for (int c = 0; c < wrapper::kBoardDim; ++c) {
                     std::string cell = "";
                     try { cell = row[c].get<std::string>(); } catch (...) { cell.clear(); }
                     if (cell.empty()) continue;
@@ -943,6 +1624,10 @@ int main(int argc, char** argv) {
             json moves = json::array();
             int count = 0;
             int top_score = 0;
+            if (!kmoves.empty()) {
+                best_move_equity = kmoves.front().equity;
+                have_best_move = true;
+            }
             for (const auto &mv : kmoves) {
                 if (count >= top_n) break;
                 Quackle::LetterString tls = mv.tiles();
@@ -953,8 +1638,11 @@ int main(int argc, char** argv) {
                 int moveScore = mv.score;
                 if (moveScore == 0 && !word.empty()) {
                     // Calculate score manually using the position
+                    // The tiles live on the generator's board, not on `pos`;
+                    // copy its position only in this rare fallback
                     Quackle::Move scoredMove = mv;
-                    pos.scoreMove(scoredMove);
+                    Quackle::GamePosition scoring_pos = gen.position();
+                    scoring_pos.scoreMove(scoredMove);
                     moveScore = scoredMove.score;
                     std::fprintf(stderr, "[wrapper] DEBUG: Calculated score for %s: %d\n", word.c_str(), moveScore);
                 }
@@ -963,7 +1651,8 @@ int main(int argc, char** argv) {
                     top_score = moveScore;
                 }
 
-                // Enforce center rule on first move: must cross (7,7)
+                // Enforce center rule on first move: must cross (7,7). Only DAWG
+                // lexica get here; GADDAG openings use the wrapper generator.
                 if (is_board_empty) {
                     bool crossesCenter = false;
                     for (size_t i = 0; i < tls.length(); ++i) {
@@ -1013,6 +1702,17 @@ int main(int argc, char** argv) {
             {"moves_returned", static_cast<int>(moves.size())}
         };
         json out = { {"moves", moves}, {"meta", meta} };
+        if (exchange_allowed) {
+            const wrapper::RackCounts rack_counts = wrapper::rack_from_string(rackStr);
+            wrapper::LeaveTable leaves(gen_workspace.arena.resource());
+            if (mapped_leaves.loaded()) leaves.build(rack_counts, mapped_leave_value);
+            else leaves.build(rack_counts, wrapper::quackle_leave_value);
+            wrapper::Exchange exchange;
+            if (wrapper::best_exchange(rack_counts, leaves, exchange))
+                out["exchange"] = exchange_json(exchange, !have_best_move ||
+                                                wrapper::equity_value(exchange.equity) > best_move_equity);
+        }
+        gen_workspace.arena.rewind();
         std::cout << out.dump() << "\n";
         std::cout.flush();
         } catch (const std::exception& e) {
@@ -1025,6 +1725,7 @@ int main(int argc, char** argv) {
             std::cout << out.dump() << "\n"; std::cout.flush();
         }
     }
+    if (reload.worker.joinable()) reload.worker.join();
     return 0;
 }
 
@@ -0,0 +1,35 @@
+#ifndef GEN_ARENA_H
+#define GEN_ARENA_H
+
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+
+namespace wrapper {
+
+// Monotonic arena for one request's transient allocations. Allocation is a
+// pointer bump inside a fixed block; rewind() after the reply makes the whole
+// block available again. Only a request that outgrows the block reaches the
+// global heap, and that overflow is returned on rewind().
+class RequestArena {
+public:
+    static constexpr size_t kDefaultBytes = 256 * 1024;
+
+    explicit RequestArena(size_t bytes = kDefaultBytes)
+        : m_block(new std::byte[bytes]), m_resource(m_block.get(), bytes, std::pmr::new_delete_resource()) {}
+
+    RequestArena(const RequestArena &) = delete;
+    RequestArena &operator=(const RequestArena &) = delete;
+
+    std::pmr::memory_resource *resource() { return &m_resource; }
+
+    void rewind() { m_resource.release(); }
+
+private:
+    std::unique_ptr<std::byte[]> m_block;
+    std::pmr::monotonic_buffer_resource m_resource;
+};
+
+} // namespace wrapper
+
+#endif // GEN_ARENA_H
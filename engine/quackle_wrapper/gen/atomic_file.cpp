@@ -0,0 +1,26 @@
+#include "gen/atomic_file.h"
+
+#include <cerrno>
+#include <cstring>
+
+namespace wrapper {
+
+bool write_file_atomically(const std::string &path, const std::function<bool(std::FILE *)> &write,
+                           std::string &error) {
+    const std::string tmp = path + ".tmp";
+    std::FILE *f = std::fopen(tmp.c_str(), "wb");
+    if (!f) {
+        error = "open: " + std::string(std::strerror(errno));
+        return false;
+    }
+    bool ok = write(f);
+    ok = std::fclose(f) == 0 && ok;
+    if (!ok || std::rename(tmp.c_str(), path.c_str()) != 0) {
+        error = "write: " + std::string(std::strerror(errno));
+        std::remove(tmp.c_str());
+        return false;
+    }
+    return true;
+}
+
+} // namespace wrapper
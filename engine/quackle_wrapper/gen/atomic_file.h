@@ -0,0 +1,19 @@
+#ifndef GEN_ATOMIC_FILE_H
+#define GEN_ATOMIC_FILE_H
+
+#include <cstdio>
+#include <functional>
+#include <string>
+
+namespace wrapper {
+
+// Writes `path` through `path + ".tmp"` beside it and a rename, so a running
+// engine never maps a half-written table. `write` fills the open file and
+// returns false on a short write; on any failure the temporary is removed,
+// `path` is left as it was and `error` says why.
+bool write_file_atomically(const std::string &path, const std::function<bool(std::FILE *)> &write,
+                           std::string &error);
+
+} // namespace wrapper
+
+#endif
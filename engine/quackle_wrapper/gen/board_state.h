@@ -0,0 +1,132 @@
+#ifndef GEN_BOARD_STATE_H
+#define GEN_BOARD_STATE_H
+
+#include <cstdint>
+
+#include "gen/rules.h"
+
+namespace wrapper {
+
+// Per-square data the generator reads. Kept per direction so that a line is
+// always a contiguous run of squares.
+struct Square {
+    uint8_t tile = 0;         // 0 = empty, else letter (| kBlankBit)
+    bool anchor = false;
+    bool has_cross = false;   // perpendicular word would be formed here
+    uint32_t cross = 0;       // letters that may be placed here (bit per letter)
+    int cross_score = 0;      // face value of the perpendicular tiles
+};
+
+// Board snapshot with anchors and cross-sets. Direction 0 plays along rows
+// (line = row, pos = col); direction 1 plays along columns (line = col, pos = row).
+template <int Dim>
+class BasicBoardState {
+public:
+    static constexpr int kDim = Dim;
+
+    void clear() {
+        for (auto &dir : m_sq)
+            for (auto &line : dir)
+                for (auto &sq : line) sq = Square();
+        m_tiles = 0;
+    }
+
+    void set_tile(int row, int col, uint8_t tile) {
+        if (!m_sq[0][row][col].tile && tile) ++m_tiles;
+        if (m_sq[0][row][col].tile && !tile) --m_tiles;
+        m_sq[0][row][col].tile = tile;
+        m_sq[1][col][row].tile = tile;
+    }
+
+    uint8_t tile(int row, int col) const { return m_sq[0][row][col].tile; }
+    bool empty() const { return m_tiles == 0; }
+    int tile_count() const { return m_tiles; }
+
+    const Square &at(int dir, int line, int pos) const { return m_sq[dir][line][pos]; }
+
+    static int row_of(int dir, int line, int pos) { return dir == 0 ? line : pos; }
+    static int col_of(int dir, int line, int pos) { return dir == 0 ? pos : line; }
+
+    bool line_has_anchor(int dir, int line) const {
+        for (int pos = 0; pos < Dim; ++pos)
+            if (m_sq[dir][line][pos].anchor) return true;
+        return false;
+    }
+
+    // Computes anchors and cross-sets; call after all tiles are placed.
+    template <class Graph>
+    void prepare(const Graph &graph, const BasicRules<Dim> &rules) {
+        const uint32_t all = rules.all_letters();
+        for (int dir = 0; dir < 2; ++dir) {
+            for (int line = 0; line < Dim; ++line) {
+                for (int pos = 0; pos < Dim; ++pos) {
+                    Square &sq = m_sq[dir][line][pos];
+                    sq.anchor = false;
+                    sq.has_cross = false;
+                    sq.cross = all;
+                    sq.cross_score = 0;
+                    if (sq.tile) continue;
+                    const int row = row_of(dir, line, pos);
+                    const int col = col_of(dir, line, pos);
+                    sq.anchor = empty() ? (row == rules.center_row && col == rules.center_col)
+                                        : has_neighbour(row, col);
+                    compute_cross(graph, rules, dir, line, pos, sq);
+                }
+            }
+        }
+    }
+
+private:
+    bool has_neighbour(int row, int col) const {
+        return (row > 0 && tile(row - 1, col)) || (row + 1 < Dim && tile(row + 1, col)) ||
+               (col > 0 && tile(row, col - 1)) || (col + 1 < Dim && tile(row, col + 1));
+    }
+
+    // Cross word for a play in `dir` runs in the other direction through the square
+    template <class Graph>
+    void compute_cross(const Graph &graph, const BasicRules<Dim> &rules, int dir, int line, int pos,
+                       Square &sq) const {
+        const int perp = 1 - dir;
+        const auto &run = m_sq[perp][pos];  // perpendicular line through the square
+        int first = line;
+        while (first > 0 && run[first - 1].tile) --first;
+        int last = line;
+        while (last + 1 < Dim && run[last + 1].tile) ++last;
+        if (first == line && last == line) return;
+
+        sq.has_cross = true;
+        for (int p = first; p <= last; ++p) {
+            if (p == line) continue;
+            const uint8_t t = run[p].tile;
+            if (!tile_is_blank(t)) sq.cross_score += rules.tile_score[tile_letter(t)];
+        }
+
+        // GADDAG path: reversed part above (if any), separator, then the
+        // candidate letter and the part below.
+        typename Graph::Node node = graph.root();
+        if (first < line) {
+            for (int p = line - 1; p >= first && node; --p) node = graph.child(node, tile_letter(run[p].tile));
+            if (node) node = graph.child(node, kSeparator);
+        }
+        uint32_t allowed = 0;
+        for (auto child = node ? graph.first_child(node) : typename Graph::Node();
+             child; child = graph.next_sibling(child)) {
+            const uint8_t letter = graph.letter(child);
+            if (letter == kSeparator) continue;
+            typename Graph::Node n = child;
+            if (first == line) n = graph.child(n, kSeparator);  // letter is the pivot
+            for (int p = line + 1; p <= last && n; ++p) n = graph.child(n, tile_letter(run[p].tile));
+            if (n && graph.terminal(n)) allowed |= 1u << letter;
+        }
+        sq.cross = allowed;
+    }
+
+    Square m_sq[2][Dim][Dim];
+    int m_tiles = 0;
+};
+
+using BoardState = BasicBoardState<kBoardDim>;
+
+} // namespace wrapper
+
+#endif // GEN_BOARD_STATE_H
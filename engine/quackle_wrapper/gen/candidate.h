@@ -0,0 +1,117 @@
+#ifndef GEN_CANDIDATE_H
+#define GEN_CANDIDATE_H
+
+#include <cmath>
+#include <cstdint>
+#include <type_traits>
+
+#include "gen/rules.h"
+
+namespace wrapper {
+
+// Equity is kept in fixed point (1/1000 of a point) so candidates stay a
+// flat 24-byte record. Rounding is monotonic, so comparing rounded bounds
+// against rounded equities is still exact.
+constexpr double kEquityScale = 1000.0;
+
+inline int32_t equity_fixed(double equity) { return static_cast<int32_t>(std::lround(equity * kEquityScale)); }
+inline double equity_value(int32_t fixed) { return fixed / kEquityScale; }
+
+// One generated placement, packed into 24 bytes on the standard board so
+// that heaps, sorts and copies of tens of thousands of candidates stay
+// cache-friendly. The word covers every square of the main word, including
+// letters already on the board, as 5-bit letters with blank and through (on
+// the board) masks. Longer lines widen the high letters and the masks.
+template <int Dim>
+struct BasicCandidate {
+    static_assert(Dim <= 24, "Candidate packs at most 24 letters");
+    using HighLetters = std::conditional_t<(Dim <= 15), uint16_t, uint64_t>;
+    using Mask = std::conditional_t<(Dim <= 16), uint16_t, uint32_t>;
+
+    uint64_t letters_lo = 0;     // letters 0..11, 5 bits each
+    HighLetters letters_hi = 0;  // letters 12 and up
+    Mask blank_mask = 0;         // bit i: letter i is a designated blank
+    Mask through_mask = 0;       // bit i: letter i was already on the board
+    uint8_t row = 0;
+    uint8_t col = 0;
+    uint8_t dir_length = 0;      // bit 7: vertical; low bits: length
+    uint8_t placed = 0;          // tiles taken from the rack
+    int16_t score = 0;
+    int32_t equity = 0;          // fixed point, see equity_fixed()
+
+    bool horizontal() const { return !(dir_length & 0x80); }
+    int length() const { return dir_length & 0x1f; }
+
+    void set_placement(int r, int c, bool across, int len) {
+        row = static_cast<uint8_t>(r);
+        col = static_cast<uint8_t>(c);
+        dir_length = static_cast<uint8_t>((across ? 0 : 0x80) | len);
+    }
+
+    // Tile i in board encoding: letter | kBlankBit | kThroughBit
+    uint8_t tile(int i) const {
+        const uint64_t bits = i < 12 ? letters_lo >> (5 * i) : static_cast<uint64_t>(letters_hi) >> (5 * (i - 12));
+        uint8_t t = static_cast<uint8_t>(bits & 0x1f);
+        if (blank_mask >> i & 1u) t |= kBlankBit;
+        if (through_mask >> i & 1u) t |= kThroughBit;
+        return t;
+    }
+
+    void set_tile(int i, uint8_t t) {
+        const uint64_t letter = tile_letter(t) & 0x1f;
+        if (i < 12) {
+            letters_lo = (letters_lo & ~(0x1fULL << (5 * i))) | letter << (5 * i);
+        } else {
+            const int shift = 5 * (i - 12);
+            letters_hi = static_cast<HighLetters>((static_cast<uint64_t>(letters_hi) & ~(0x1fULL << shift)) |
+                                                  letter << shift);
+        }
+        const Mask bit = static_cast<Mask>(1u << i);
+        blank_mask = tile_is_blank(t) ? (blank_mask | bit) : (blank_mask & ~bit);
+        through_mask = tile_is_through(t) ? (through_mask | bit) : (through_mask & ~bit);
+    }
+};
+
+using Candidate = BasicCandidate<kBoardDim>;
+
+static_assert(sizeof(Candidate) == 24, "Candidate is meant to stay a packed 24-byte record");
+
+// Total order used everywhere candidates are ranked: equity, then score, then
+// placement. Serial and parallel generation therefore pick the same top-N.
+template <int Dim>
+inline bool candidate_before(const BasicCandidate<Dim> &a, const BasicCandidate<Dim> &b) {
+    if (a.equity != b.equity) return a.equity > b.equity;
+    if (a.score != b.score) return a.score > b.score;
+    if (a.horizontal() != b.horizontal()) return a.horizontal();
+    if (a.row != b.row) return a.row < b.row;
+    if (a.col != b.col) return a.col < b.col;
+    if (a.length() != b.length()) return a.length() < b.length();
+    if (a.letters_lo != b.letters_lo) return a.letters_lo < b.letters_lo;
+    if (a.letters_hi != b.letters_hi) return a.letters_hi < b.letters_hi;
+    return a.blank_mask < b.blank_mask;
+}
+
+static_assert(kMaxRackTiles <= 8, "candidate_key packs at most 8 placed tiles");
+
+// Exact 64-bit key of a placement: start square, direction, length and the
+// tiles taken from the rack (board tiles follow from the rest). Fits up to
+// 8 placed tiles of 6 bits each and rows, columns and lengths up to 31;
+// never 0 because length is at least 1.
+template <int Dim>
+inline uint64_t candidate_key(const BasicCandidate<Dim> &c) {
+    uint64_t key = static_cast<uint64_t>(c.length()) | static_cast<uint64_t>(c.horizontal()) << 5 |
+                   static_cast<uint64_t>(c.row) << 6 | static_cast<uint64_t>(c.col) << 11;
+    int shift = 16;
+    for (int i = 0; i < c.length() && shift < 64; ++i) {
+        const uint8_t t = c.tile(i);
+        if (tile_is_through(t)) continue;
+        const uint64_t tile = tile_letter(t) | (tile_is_blank(t) ? 0x20u : 0u);
+        key |= tile << shift;
+        shift += 6;
+    }
+    return key;
+}
+
+} // namespace wrapper
+
+#endif // GEN_CANDIDATE_H
@@ -0,0 +1,49 @@
+#ifndef GEN_CONSTRAINTS_H
+#define GEN_CONSTRAINTS_H
+
+#include <cstdint>
+
+#include "gen/rack.h"
+#include "gen/rules.h"
+
+namespace wrapper {
+
+// Restrictions on which plays are generated at all, for puzzles and hints.
+// They are checked while the GADDAG is walked, so a bounded top-K is always
+// filled with plays that satisfy them instead of being filtered afterwards.
+// The board's own first-move rule needs none of this: on an empty board the
+// centre square is the only anchor.
+struct GenConstraints {
+    static constexpr uint8_t kAcross = 1;
+    static constexpr uint8_t kDown = 2;
+
+    uint8_t directions = kAcross | kDown;
+    int cover_row = -1;      // with cover_col, a square the main word must cover
+    int cover_col = -1;
+    int min_length = 0;      // main word length, board tiles included
+    int max_length = 0;      // 0 = no limit
+    RackCounts must_use;     // letters the play must place (blanks count as
+                             // the letter they are designated)
+    bool use_all = false;    // only plays that empty the rack
+
+    bool allows_direction(int dir) const { return directions >> dir & 1u; }
+    bool has_cover() const { return cover_row >= 0 && cover_col >= 0; }
+
+    // Direction, length and covered square of a main word
+    bool allows_word(int row, int col, bool across, int length) const {
+        if (!allows_direction(across ? 0 : 1)) return false;
+        if (length < min_length || (max_length && length > max_length)) return false;
+        if (!has_cover()) return true;
+        return across ? row == cover_row && cover_col >= col && cover_col < col + length
+                      : col == cover_col && cover_row >= row && cover_row < row + length;
+    }
+
+    bool any() const {
+        return directions != (kAcross | kDown) || has_cover() || min_length > 0 || max_length > 0 ||
+               !must_use.empty() || use_all;
+    }
+};
+
+} // namespace wrapper
+
+#endif // GEN_CONSTRAINTS_H
@@ -0,0 +1,76 @@
+#ifndef GEN_EXCHANGE_H
+#define GEN_EXCHANGE_H
+
+#include <cstdint>
+
+#include "gen/candidate.h"
+#include "gen/leaves.h"
+#include "gen/rack.h"
+
+namespace wrapper {
+
+constexpr int kMaxExchangeTiles = kMaxRackTiles;
+
+// An exchange scores nothing, so its equity is the value of the kept leave
+struct Exchange {
+    RackCounts tiles;  // returned to the bag
+    RackCounts keep;
+    int32_t equity = 0;  // fixed point, see equity_fixed()
+};
+
+// Best exchange of at least one tile. Kept subsets are walked as bitmasks
+// over the rack's tiles; a subset's leave index is its lowest tile's stride
+// plus the index of the rest, and subsets that keep the same multiset share
+// an index, so each distinct leave is valued once. Ties keep the subset
+// found first, i.e. the smallest mask. False if the rack is empty or longer
+// than kMaxExchangeTiles.
+inline bool best_exchange(const RackCounts &rack, const LeaveTable &leaves, Exchange &out) {
+    if (rack.empty() || rack.size > kMaxExchangeTiles) return false;
+    uint8_t tiles[kMaxExchangeTiles];  // kSeparator stands for a blank
+    int strides[kMaxExchangeTiles];
+    int n = 0;
+    for (int b = 0; b < rack.blanks; ++b) tiles[n++] = kSeparator;
+    for (int l = 1; l < kMaxLetters; ++l)
+        for (int k = 0; k < rack.counts[l]; ++k) tiles[n++] = static_cast<uint8_t>(l);
+    for (int i = 0; i < n; ++i) {
+        RackCounts one;
+        if (tiles[i] == kSeparator) one.add_blank();
+        else one.add(tiles[i]);
+        strides[i] = leaves.index_of(one);
+    }
+
+    const uint32_t full = (1u << n) - 1;
+    int index[1u << kMaxExchangeTiles];
+    uint8_t seen[1u << kMaxExchangeTiles] = {};
+    index[0] = 0;
+    uint32_t best_mask = 0;
+    double best_value = 0.0;
+    bool found = false;
+    for (uint32_t mask = 0; mask < full; ++mask) {
+        if (mask) {
+            const int low = __builtin_ctz(mask);
+            index[mask] = index[mask & (mask - 1)] + strides[low];
+        }
+        if (seen[index[mask]]) continue;
+        seen[index[mask]] = 1;
+        const double value = leaves.value_at(index[mask]);
+        if (!found || value > best_value) {
+            best_value = value;
+            best_mask = mask;
+            found = true;
+        }
+    }
+
+    out = Exchange();
+    for (int i = 0; i < n; ++i) {
+        RackCounts &side = best_mask >> i & 1u ? out.keep : out.tiles;
+        if (tiles[i] == kSeparator) side.add_blank();
+        else side.add(tiles[i]);
+    }
+    out.equity = equity_fixed(best_value);
+    return true;
+}
+
+} // namespace wrapper
+
+#endif // GEN_EXCHANGE_H
@@ -0,0 +1,228 @@
+#include "gen/gaddag_builder.h"
+
+#include <algorithm>
+#include <cctype>
+#include <condition_variable>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace wrapper {
+
+namespace {
+
+uint64_t mix(uint64_t h, uint64_t v) { return (h ^ v) * 0x100000001b3ull; }
+
+} // namespace
+
+size_t GaddagBuilder::StateStore::Hash::operator()(uint32_t state) const {
+    const StateStore &s = *store;
+    uint64_t h = mix(0xcbf29ce484222325ull, s.final[state]);
+    for (uint32_t i = s.first[state], end = i + s.count[state]; i < end; ++i)
+        h = mix(mix(h, s.arcs[i].letter), s.arcs[i].target);
+    return static_cast<size_t>(h ^ h >> 29);
+}
+
+bool GaddagBuilder::StateStore::Equal::operator()(uint32_t x, uint32_t y) const {
+    const StateStore &s = *store;
+    if (s.final[x] != s.final[y] || s.count[x] != s.count[y]) return false;
+    const Arc *ax = &s.arcs[s.first[x]];
+    const Arc *ay = &s.arcs[s.first[y]];
+    for (uint32_t i = 0; i < s.count[x]; ++i)
+        if (ax[i].letter != ay[i].letter || ax[i].target != ay[i].target) return false;
+    return true;
+}
+
+uint32_t GaddagBuilder::StateStore::intern(bool is_final, size_t from) {
+    const uint32_t state = static_cast<uint32_t>(first.size());
+    first.push_back(static_cast<uint32_t>(from));
+    count.push_back(static_cast<uint8_t>(arcs.size() - from));
+    final.push_back(is_final);
+    if (count.back()) arcs.back().last = true;
+    const auto placed = m_register.insert(state);
+    if (placed.second) return state;
+    first.pop_back();
+    count.pop_back();
+    final.pop_back();
+    arcs.resize(from);
+    return *placed.first;
+}
+
+void GaddagBuilder::StateStore::clear() {
+    m_register = decltype(m_register)(0, Hash{this}, Equal{this});
+    arcs = std::vector<Arc>();
+    first = std::vector<uint32_t>();
+    count = std::vector<uint8_t>();
+    final = std::vector<uint8_t>();
+}
+
+bool GaddagBuilder::add_word(const std::string &word) {
+    const size_t start = m_letters.size();
+    bool ok = !word.empty() && word.size() <= kMaxWord;
+    for (size_t i = 0; ok && i < word.size(); ++i) {
+        const int upper = std::toupper(static_cast<unsigned char>(word[i]));
+        ok = upper >= 'A' && upper <= 'Z';
+        m_letters.push_back(static_cast<char>(upper - 'A' + 1));
+    }
+    if (!ok) {
+        m_letters.resize(start);
+        ++m_stats.skipped;
+        return false;
+    }
+    m_ends.push_back(static_cast<uint32_t>(m_letters.size()));
+    ++m_stats.words;
+    return true;
+}
+
+uint32_t GaddagBuilder::build_shard(uint8_t pivot, StateStore &out, ShardCount &shard_count) const {
+    // Every split of every word at this letter: the letters before it
+    // reversed, then the separator and the rest (nothing when the split is
+    // at the end). The pivot itself is the arc into the shard.
+    std::vector<std::string> strings;
+    std::string s;
+    for (size_t w = 0, begin = 0; w < m_ends.size(); begin = m_ends[w++]) {
+        const char *letters = m_letters.data() + begin;
+        const size_t n = m_ends[w] - begin;
+        for (size_t i = 0; i < n; ++i) {
+            if (static_cast<uint8_t>(letters[i]) != pivot) continue;
+            s.assign(std::make_reverse_iterator(letters + i), std::make_reverse_iterator(letters));
+            if (i + 1 < n) {
+                s.push_back(0);
+                s.append(letters + i + 1, n - i - 1);
+            }
+            strings.push_back(s);
+        }
+    }
+    shard_count.strings = strings.size();
+    std::sort(strings.begin(), strings.end());
+    strings.erase(std::unique(strings.begin(), strings.end()), strings.end());
+
+    // Incremental construction from sorted input: the states along the last
+    // string stay open; once a string branches off, the states below the
+    // branch are complete and are interned deepest first, so each one is
+    // replaced by an equal stored state or stored itself
+    std::vector<std::vector<std::pair<uint8_t, uint32_t>>> open(1);  // arcs by depth
+    std::vector<uint8_t> open_final(1, 0);
+    size_t depth = 0;
+    shard_count.trie_states = 1;
+    auto intern_open = [&](size_t d) {
+        const size_t from = out.arcs.size();
+        for (const auto &arc : open[d]) out.add_arc(arc.first, arc.second);
+        return out.intern(open_final[d] != 0, from);
+    };
+    auto close_below = [&](size_t keep) {
+        for (; depth > keep; --depth) open[depth - 1].back().second = intern_open(depth);
+    };
+    const std::string *prev = nullptr;
+    for (const std::string &str : strings) {
+        size_t common = 0;
+        if (prev) common = std::mismatch(prev->begin(), prev->end(), str.begin(), str.end()).first - prev->begin();
+        close_below(common);
+        shard_count.trie_states += str.size() - common;
+        for (size_t i = common; i < str.size(); ++i) {
+            open[depth].emplace_back(static_cast<uint8_t>(str[i]), 0);
+            if (open.size() == ++depth) {
+                open.emplace_back();
+                open_final.push_back(0);
+            }
+            open[depth].clear();
+            open_final[depth] = 0;
+        }
+        open_final[depth] = 1;
+        prev = &str;
+    }
+    close_below(0);
+    return intern_open(0);
+}
+
+void GaddagBuilder::build(int threads, size_t max_strings) {
+    if (threads <= 0) threads = static_cast<int>(std::thread::hardware_concurrency());
+    if (threads < 1) threads = 1;
+
+    // A shard has one string per occurrence of its letter; the largest go
+    // first so the last to finish are short
+    size_t sizes[27] = {};
+    for (char c : m_letters) ++sizes[static_cast<uint8_t>(c)];
+    std::vector<uint8_t> pivots;
+    for (uint8_t l = 1; l <= 26; ++l)
+        if (sizes[l]) pivots.push_back(l);
+    std::stable_sort(pivots.begin(), pivots.end(), [&](uint8_t a, uint8_t b) { return sizes[a] > sizes[b]; });
+
+    std::vector<std::unique_ptr<StateStore>> shards(27);
+    uint32_t shard_roots[27] = {};
+    ShardCount shard_counts[27];
+    // Shards start in order, each once the strings in flight leave room for
+    // it under the budget
+    std::mutex mutex;
+    std::condition_variable room;
+    size_t next = 0;
+    size_t held = 0;
+    size_t peak = 0;
+    auto work = [&]() {
+        for (;;) {
+            uint8_t l;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                room.wait(lock, [&] {
+                    return next == pivots.size() || held == 0 || held + sizes[pivots[next]] <= max_strings;
+                });
+                if (next == pivots.size()) return;
+                l = pivots[next++];
+                held += sizes[l];
+                peak = std::max(peak, held);
+            }
+            shards[l] = std::make_unique<StateStore>();
+            shard_roots[l] = build_shard(l, *shards[l], shard_counts[l]);
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                held -= sizes[l];
+            }
+            room.notify_all();
+        }
+    };
+    std::vector<std::thread> workers;
+    for (int t = 1; t < std::min<int>(threads, static_cast<int>(pivots.size())); ++t) workers.emplace_back(work);
+    work();
+    for (auto &w : workers) w.join();
+    m_letters = std::string();
+    m_ends = std::vector<uint32_t>();
+
+    // Merged in letter order, so the graph does not depend on the threads.
+    // Shard states come children first, so re-interning them in id order
+    // shares every subtree two shards have in common.
+    m_graph.clear();
+    m_graph.arcs.push_back(Arc{0, false, true, 0});
+    size_t shard_states = 0;
+    for (const auto &shard : shards) shard_states += shard ? shard->size() : 0;
+    m_graph.reserve(shard_states);
+    uint32_t roots[27] = {};
+    std::vector<uint32_t> merged;
+    for (uint8_t l = 1; l <= 26; ++l) {
+        if (!shards[l]) continue;
+        const StateStore &shard = *shards[l];
+        merged.resize(shard.size());
+        for (uint32_t st = 0; st < shard.size(); ++st) {
+            const size_t from = m_graph.arcs.size();
+            for (uint32_t i = shard.first[st], end = i + shard.count[st]; i < end; ++i)
+                m_graph.add_arc(shard.arcs[i].letter, merged[shard.arcs[i].target]);
+            merged[st] = m_graph.intern(shard.final[st] != 0, from);
+        }
+        roots[l] = merged[shard_roots[l]];
+        m_stats.strings += shard_counts[l].strings;
+        m_stats.trie_states += shard_counts[l].trie_states;
+        m_stats.largest_shard = std::max(m_stats.largest_shard, shard_counts[l].strings);
+        shards[l].reset();
+    }
+    const size_t from = m_graph.arcs.size();
+    for (uint8_t l = 1; l <= 26; ++l)
+        if (sizes[l]) m_graph.add_arc(l, roots[l]);
+    m_graph.arcs[0].target = m_graph.intern(false, from);
+    m_stats.trie_states += 1;  // the root
+    m_stats.shard_states = shard_states;
+    m_stats.peak_strings = peak;
+    m_stats.states = m_graph.size();
+    m_stats.arcs = m_graph.arcs.size() - 1;
+}
+
+} // namespace wrapper
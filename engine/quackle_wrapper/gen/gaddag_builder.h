@@ -0,0 +1,142 @@
+#ifndef GEN_GADDAG_BUILDER_H
+#define GEN_GADDAG_BUILDER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+namespace wrapper {
+
+// Builds a minimal GADDAG from a word list without Quackle: the graph
+// tools/mapgaddag would produce from Quackle's factory output, but with
+// every identical subtree stored once.
+//
+// Words are kept once, as letters. build() splits the GADDAG strings by
+// their first letter (the pivot) into 26 shards; each worker expands,
+// sorts and minimises one shard at a time (Daciuk et al., incremental
+// construction from sorted input), so only the shards in flight are ever
+// held as strings. A string budget, apart from the thread count, bounds
+// how many are in flight at once. The shards are then merged bottom-up
+// through one register, which shares the suffix subtrees they have in
+// common.
+//
+// The result has the generator's graph interface, so pack_graph turns it
+// into a mapped GADDAG. Letters are 1..26 and 0 is the separator.
+class GaddagBuilder {
+public:
+    struct Arc {
+        uint8_t letter;
+        bool terminal;  // the string ending with this letter is in the graph
+        bool last;      // last of its sibling run
+        uint32_t target;  // state whose arcs are the children
+    };
+    using Node = const Arc *;
+
+    struct Stats {
+        size_t words = 0;
+        size_t skipped = 0;       // words with characters other than A-Z
+        size_t strings = 0;       // GADDAG strings, duplicates included
+        size_t trie_states = 0;   // states of the same strings as a plain trie
+        size_t shard_states = 0;  // states of the minimised shards before the merge
+        size_t states = 0;
+        size_t arcs = 0;
+        size_t largest_shard = 0; // strings in the largest shard
+        size_t peak_strings = 0;  // most strings held by the shards in flight at once
+    };
+
+    GaddagBuilder() = default;
+    GaddagBuilder(const GaddagBuilder &) = delete;
+    GaddagBuilder &operator=(const GaddagBuilder &) = delete;
+
+    // Queues a word (upper or lower case A-Z); false if it has anything else
+    // or is longer than kMaxWord
+    bool add_word(const std::string &word);
+
+    // Builds the graph on up to `threads` workers (0 = one per hardware
+    // thread). A shard only starts while the shards in flight hold at most
+    // `max_strings` strings with it, or when none is in flight, so a big
+    // host does not expand every shard at once. The word list is dropped
+    // afterwards.
+    void build(int threads, size_t max_strings = kDefaultMaxStrings);
+
+    const Stats &stats() const { return m_stats; }
+
+    Node root() const { return &m_graph.arcs[0]; }
+    Node first_child(Node node) const {
+        return m_graph.count[node->target] ? &m_graph.arcs[m_graph.first[node->target]] : nullptr;
+    }
+    Node next_sibling(Node node) const { return node->last ? nullptr : node + 1; }
+    uint8_t letter(Node node) const { return node->letter; }
+    bool terminal(Node node) const { return node->terminal; }
+    Node child(Node node, uint8_t letter) const {
+        for (Node n = first_child(node); n; n = next_sibling(n))
+            if (n->letter == letter) return n;
+        return nullptr;
+    }
+
+    static constexpr size_t kMaxWord = 64;
+    // About 150 MB of shard strings
+    static constexpr size_t kDefaultMaxStrings = size_t(1) << 22;
+
+private:
+    // Minimised states: state s owns arcs [first[s], first[s] + count[s]).
+    // A state is added after its children, so equal arcs mean equal
+    // subtrees and ids run children first.
+    class StateStore {
+    public:
+        std::vector<Arc> arcs;
+        std::vector<uint32_t> first;
+        std::vector<uint8_t> count;
+        std::vector<uint8_t> final;
+
+        StateStore() : m_register(0, Hash{this}, Equal{this}) {}
+        StateStore(const StateStore &) = delete;
+        StateStore &operator=(const StateStore &) = delete;
+
+        size_t size() const { return first.size(); }
+        // Appends an arc to the state being assembled at the end of `arcs`
+        void add_arc(uint8_t letter, uint32_t target) {
+            arcs.push_back(Arc{letter, final[target] != 0, false, target});
+        }
+        // The state with the arcs from `from` on: an equal one already
+        // stored (the arcs are dropped), or a new one
+        uint32_t intern(bool is_final, size_t from);
+        void reserve(size_t states) { m_register.reserve(states); }
+        void clear();
+
+    private:
+        struct Hash {
+            const StateStore *store;
+            size_t operator()(uint32_t state) const;
+        };
+        struct Equal {
+            const StateStore *store;
+            bool operator()(uint32_t a, uint32_t b) const;
+        };
+        std::unordered_set<uint32_t, Hash, Equal> m_register;
+    };
+
+    struct ShardCount {
+        size_t strings = 0;
+        size_t trie_states = 0;
+    };
+
+    // Minimises the strings of one pivot letter into `out`; returns the
+    // state they start from
+    uint32_t build_shard(uint8_t pivot, StateStore &out, ShardCount &count) const;
+
+    // Words as letters 1..26, back to back
+    std::string m_letters;
+    std::vector<uint32_t> m_ends;
+
+    // Arc 0 is the root, pointing at the state of the whole string set
+    StateStore m_graph;
+
+    Stats m_stats;
+};
+
+} // namespace wrapper
+
+#endif // GEN_GADDAG_BUILDER_H
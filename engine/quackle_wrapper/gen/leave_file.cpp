@@ -0,0 +1,96 @@
+#include "gen/leave_file.h"
+
+#include "gen/atomic_file.h"
+
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace wrapper {
+
+namespace {
+
+LeaveFileHeader expected_header() {
+    LeaveFileHeader h{};
+    std::memcpy(h.magic, kLeaveFileMagic, sizeof(h.magic));
+    h.version = kLeaveFileVersion;
+    h.types = kLeaveTypes;
+    h.max_tiles = kMaxLeaveTiles;
+    h.scale = static_cast<uint32_t>(kEquityScale);
+    h.count = kLeaveCount;
+    return h;
+}
+
+} // namespace
+
+bool MappedLeaves::open(const std::string &path, std::string &error) {
+    close();
+    const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        error = "open: " + std::string(std::strerror(errno));
+        return false;
+    }
+    struct stat st{};
+    if (::fstat(fd, &st) != 0) {
+        error = "fstat: " + std::string(std::strerror(errno));
+        ::close(fd);
+        return false;
+    }
+    const size_t bytes = static_cast<size_t>(st.st_size);
+    const size_t expected = sizeof(LeaveFileHeader) + size_t(kLeaveCount) * sizeof(int32_t);
+    if (bytes != expected) {
+        error = "size " + std::to_string(bytes) + ", expected " + std::to_string(expected);
+        ::close(fd);
+        return false;
+    }
+    void *map = ::mmap(nullptr, bytes, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (map == MAP_FAILED) {
+        error = "mmap: " + std::string(std::strerror(errno));
+        return false;
+    }
+
+    const LeaveFileHeader want = expected_header();
+    if (std::memcmp(map, &want, sizeof(want)) != 0) {
+        error = "header mismatch (format, version or table shape)";
+        ::munmap(map, bytes);
+        return false;
+    }
+    m_map = map;
+    m_bytes = bytes;
+    m_values = reinterpret_cast<const int32_t *>(static_cast<const char *>(map) + sizeof(LeaveFileHeader));
+    return true;
+}
+
+void MappedLeaves::close() {
+    release_resident(m_map, m_bytes, m_residency);
+    m_map = nullptr;
+    m_bytes = 0;
+    m_values = nullptr;
+    m_residency = Residency();
+}
+
+void MappedLeaves::apply_residency(const ResidencyOptions &options) {
+    if (!m_map || !options.any()) return;
+    make_resident(m_map, m_bytes, options, m_residency);
+    m_values = reinterpret_cast<const int32_t *>(static_cast<const char *>(m_map) + sizeof(LeaveFileHeader));
+}
+
+bool write_leave_file(const std::string &path, const std::vector<int32_t> &values, std::string &error) {
+    if (values.size() != kLeaveCount) {
+        error = "expected " + std::to_string(kLeaveCount) + " values, got " + std::to_string(values.size());
+        return false;
+    }
+    return write_file_atomically(path, [&values](std::FILE *f) {
+        const LeaveFileHeader header = expected_header();
+        return std::fwrite(&header, sizeof(header), 1, f) == 1 &&
+               std::fwrite(values.data(), sizeof(int32_t), values.size(), f) == values.size();
+    }, error);
+}
+
+} // namespace wrapper
@@ -0,0 +1,113 @@
+#ifndef GEN_LEAVE_FILE_H
+#define GEN_LEAVE_FILE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "gen/candidate.h"
+#include "gen/rack.h"
+#include "gen/residency.h"
+
+namespace wrapper {
+
+// Dense leave table: the value of every leave of 0..kMaxLeaveTiles tiles over
+// the blank and 26 letters, indexed by a perfect rank of the multiset.
+// Written offline by tools/makeleaves, memory-mapped by the engine.
+constexpr int kLeaveTypes = 27;  // type 0 is the blank, 1..26 the letters
+constexpr int kMaxLeaveTiles = 6;
+static_assert(kMaxLeaveTiles >= kMaxRackTiles - 1, "a play or exchange keeps at most rack - 1 tiles");
+
+namespace leave_detail {
+
+struct Binomials {
+    uint32_t c[kLeaveTypes + kMaxLeaveTiles][kMaxLeaveTiles + 1] = {};
+    uint32_t offset[kMaxLeaveTiles + 2] = {};  // first rank of each leave size
+
+    constexpr Binomials() {
+        for (int n = 0; n < kLeaveTypes + kMaxLeaveTiles; ++n) {
+            c[n][0] = 1;
+            for (int k = 1; k <= kMaxLeaveTiles && k <= n; ++k) c[n][k] = c[n - 1][k - 1] + (k < n ? c[n - 1][k] : 0);
+        }
+        for (int k = 0; k <= kMaxLeaveTiles; ++k) offset[k + 1] = offset[k] + c[kLeaveTypes - 1 + k][k];
+    }
+};
+
+constexpr Binomials kBinomials;
+
+} // namespace leave_detail
+
+// Number of distinct leaves, i.e. entries in the table
+constexpr uint32_t kLeaveCount = leave_detail::kBinomials.offset[kMaxLeaveTiles + 1];
+
+// Leaves are ordered by size, then by the colex rank of their sorted types
+// t1 <= ... <= tk, made strictly increasing as ci = ti + i - 1. `leave` must
+// hold at most kMaxLeaveTiles tiles.
+inline uint32_t leave_rank(const RackCounts &leave) {
+    const auto &b = leave_detail::kBinomials;
+    uint32_t rank = b.offset[leave.size];
+    int i = 0;
+    for (int n = leave.blanks; n > 0; --n, ++i) rank += b.c[i][i + 1];
+    for (int l = 1; l < kLeaveTypes; ++l)
+        for (int n = leave.counts[l]; n > 0; --n, ++i) rank += b.c[l + i][i + 1];
+    return rank;
+}
+
+// Fixed header of a leave file; values follow as kLeaveCount int32 in
+// equity fixed point (see equity_fixed), native byte order.
+struct LeaveFileHeader {
+    char magic[8];         // "LEAVES\0\0"
+    uint32_t version;
+    uint32_t types;        // kLeaveTypes
+    uint32_t max_tiles;    // kMaxLeaveTiles
+    uint32_t scale;        // kEquityScale
+    uint64_t count;        // kLeaveCount
+};
+
+constexpr char kLeaveFileMagic[8] = {'L', 'E', 'A', 'V', 'E', 'S', 0, 0};
+constexpr uint32_t kLeaveFileVersion = 1;
+
+// Read-only view of a leave file mapped into memory. Lookups are one rank
+// computation and one load; pages are shared by every process mapping it.
+class MappedLeaves {
+public:
+    MappedLeaves() = default;
+    ~MappedLeaves() { close(); }
+
+    MappedLeaves(const MappedLeaves &) = delete;
+    MappedLeaves &operator=(const MappedLeaves &) = delete;
+
+    // On failure `error` says why and the view stays unloaded
+    bool open(const std::string &path, std::string &error);
+    void close();
+
+    // Copies, places or locks the table per `options` (gen/residency.h)
+    void apply_residency(const ResidencyOptions &options);
+
+    bool loaded() const { return m_values != nullptr; }
+    size_t bytes() const { return m_bytes; }
+    const Residency &residency() const { return m_residency; }
+    size_t resident_bytes() const { return wrapper::resident_bytes(m_map, m_bytes); }
+    size_t huge_page_bytes() const { return wrapper::huge_page_bytes(m_map, m_bytes, m_residency); }
+
+    // A leave longer than the table (only ever a whole unplayed rack) is 0
+    int32_t fixed(const RackCounts &leave) const {
+        return leave.size > kMaxLeaveTiles ? 0 : m_values[leave_rank(leave)];
+    }
+    double value(const RackCounts &leave) const { return equity_value(fixed(leave)); }
+
+private:
+    void *m_map = nullptr;
+    size_t m_bytes = 0;
+    const int32_t *m_values = nullptr;
+    Residency m_residency;
+};
+
+// Writes a leave file; `values` is indexed by leave_rank and has kLeaveCount
+// entries
+bool write_leave_file(const std::string &path, const std::vector<int32_t> &values, std::string &error);
+
+} // namespace wrapper
+
+#endif // GEN_LEAVE_FILE_H
@@ -0,0 +1,131 @@
+#ifndef GEN_LEAVES_H
+#define GEN_LEAVES_H
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <functional>
+#include <memory_resource>
+#include <vector>
+
+#include "gen/candidate.h"
+#include "gen/rack.h"
+
+namespace wrapper {
+
+// Leave values for every sub-multiset of one rack, computed before generation
+// so that worker threads only ever read it. A 7-tile rack has at most 128
+// distinct leaves; the index is mixed-radix over the rack's distinct letters.
+class LeaveTable {
+public:
+    using ValueFn = std::function<double(const RackCounts &leave)>;
+
+    explicit LeaveTable(std::pmr::memory_resource *mem = std::pmr::get_default_resource())
+        : m_letters(mem), m_strides(mem), m_values(mem), m_fixed(mem), m_best_within(mem) {}
+    LeaveTable(const RackCounts &rack, const ValueFn &value_of,
+               std::pmr::memory_resource *mem = std::pmr::get_default_resource())
+        : LeaveTable(mem) {
+        build(rack, value_of);
+    }
+
+    // The table has one entry per sub-multiset of `rack`, which callers
+    // bound to kMaxRackTiles tiles
+    void build(const RackCounts &rack, const ValueFn &value_of) {
+        assert(rack.size <= kMaxRackTiles);
+        m_letters.clear();
+        m_strides.clear();
+        m_values.clear();
+        m_fixed.clear();
+        std::fill(std::begin(m_stride_of), std::end(m_stride_of), 0);
+        int total = 1;
+        if (rack.blanks) {
+            m_letters.push_back(kSeparator);  // slot 0 stands for blanks
+            m_strides.push_back(total);
+            m_stride_of[kSeparator] = total;
+            total *= rack.blanks + 1;
+        }
+        for (int l = 1; l < kMaxLetters; ++l) {
+            if (!rack.counts[l]) continue;
+            m_letters.push_back(static_cast<uint8_t>(l));
+            m_strides.push_back(total);
+            m_stride_of[l] = total;
+            total *= rack.counts[l] + 1;
+        }
+        m_values.assign(total, 0.0);
+        m_fixed.assign(total, 0);
+        m_best_within.clear();
+        if (!value_of) return;
+
+        for (int index = 0; index < total; ++index) {
+            RackCounts leave;
+            for (size_t i = 0; i < m_letters.size(); ++i) {
+                const uint8_t l = m_letters[i];
+                const int n = (index / m_strides[i]) % (digit_limit(rack, i) + 1);
+                for (int k = 0; k < n; ++k) {
+                    if (l == kSeparator) leave.add_blank();
+                    else leave.add(l);
+                }
+            }
+            m_values[index] = value_of(leave);
+            m_fixed[index] = equity_fixed(m_values[index]);
+        }
+
+        // Indices only decrease when a letter is removed, so one ascending
+        // pass sees every sub-multiset before the multisets containing it
+        m_best_within = m_values;
+        for (int index = 0; index < total; ++index) {
+            for (size_t i = 0; i < m_letters.size(); ++i) {
+                if ((index / m_strides[i]) % (digit_limit(rack, i) + 1) == 0) continue;
+                m_best_within[index] = std::max(m_best_within[index], m_best_within[index - m_strides[i]]);
+            }
+        }
+    }
+
+    // `leave` must be a sub-multiset of the rack the table was built for
+    int index_of(const RackCounts &leave) const {
+        int index = 0;
+        for (size_t i = 0; i < m_letters.size(); ++i) {
+            const uint8_t l = m_letters[i];
+            index += (l == kSeparator ? leave.blanks : leave.counts[l]) * m_strides[i];
+        }
+        return index;
+    }
+
+    double value(const RackCounts &leave) const {
+        return m_values.empty() ? 0.0 : m_values[index_of(leave)];
+    }
+
+    // Value by index, for callers that build indices from strides
+    double value_at(int index) const { return m_values.empty() ? 0.0 : m_values[index]; }
+
+    // Best value among the sub-multisets of `leave`: whatever a partial play
+    // still places, its final leave is one of them. Turns score bounds into
+    // equity bounds.
+    double best_within(const RackCounts &leave) const { return best_within_at(index_of(leave)); }
+    double best_within_at(int index) const { return m_best_within.empty() ? 0.0 : m_best_within[index]; }
+
+    // Index step for one tile of `letter` (kSeparator for a blank): using the
+    // tile lowers a leave's index by this much, so callers that take tiles
+    // one at a time can track the index without index_of()
+    int stride(uint8_t letter) const { return m_stride_of[letter]; }
+
+    // Leave values in equity fixed point, by index; empty if never valued
+    const int32_t *fixed_values() const { return m_fixed.empty() ? nullptr : m_fixed.data(); }
+
+private:
+    int digit_limit(const RackCounts &rack, size_t i) const {
+        const uint8_t l = m_letters[i];
+        return l == kSeparator ? rack.blanks : rack.counts[l];
+    }
+
+    std::pmr::vector<uint8_t> m_letters;
+    std::pmr::vector<int> m_strides;
+    std::pmr::vector<double> m_values;
+    std::pmr::vector<int32_t> m_fixed;
+    std::pmr::vector<double> m_best_within;
+    int m_stride_of[kMaxLetters] = {};
+};
+
+} // namespace wrapper
+
+#endif // GEN_LEAVES_H
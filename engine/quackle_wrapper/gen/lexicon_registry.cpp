@@ -0,0 +1,119 @@
+#include "gen/lexicon_registry.h"
+
+#include <cctype>
+#include <cstdio>
+
+namespace wrapper {
+
+bool LexiconRegistry::add(const std::string &name, const std::string &path) {
+    if (name.empty() || name.size() > 32 || path.empty()) return false;
+    for (unsigned char c : name)
+        if (!std::isalnum(c) && c != '_' && c != '-') return false;
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (find(name)) return false;
+    m_entries.push_back(Entry{name, path, nullptr, 0, 0, 0, std::string(), false});
+    return true;
+}
+
+bool LexiconRegistry::contains(const std::string &name) const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return find(name) != nullptr;
+}
+
+std::shared_ptr<const MappedGraph> LexiconRegistry::acquire(const std::string &name, std::string &error) {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    Entry *entry = find(name);
+    if (!entry) {
+        error = "unknown lexicon '" + name + "'";
+        return nullptr;
+    }
+    entry->last_used = ++m_clock;
+    ++entry->uses;
+    if (entry->loading) {
+        // Share the load in flight, whatever its outcome; add() may move the
+        // entries meanwhile, so look this one up again
+        m_loaded.wait(lock, [this, &name] { return !find(name)->loading; });
+        entry = find(name);
+        if (!entry->graph) error = entry->path + ": " + entry->error;
+        return entry->graph;
+    }
+    if (entry->graph) return entry->graph;
+
+    entry->loading = true;
+    const std::string path = entry->path;
+    lock.unlock();
+    auto graph = std::make_shared<MappedGraph>();
+    std::string load_error;
+    bool ok = false;
+    try {
+        ok = graph->open(path, load_error);
+        if (ok) graph->apply_residency(m_residency);
+    } catch (...) {
+        lock.lock();
+        find(name)->loading = false;
+        m_loaded.notify_all();
+        throw;
+    }
+    lock.lock();
+    entry = find(name);
+    entry->loading = false;
+    m_loaded.notify_all();
+    if (!ok) {
+        entry->error = load_error;
+        error = path + ": " + load_error;
+        std::fprintf(stderr, "[lexica] ✗ %s: %s\n", name.c_str(), error.c_str());
+        return nullptr;
+    }
+    entry->error.clear();
+    ++entry->loads;
+    m_resident += graph->bytes();
+    entry->graph = std::move(graph);
+    std::fprintf(stderr, "[lexica] mapped %s (%zu bytes, resident %zu)\n", name.c_str(), entry->graph->bytes(),
+                 m_resident);
+    evict(entry);
+    return entry->graph;
+}
+
+size_t LexiconRegistry::resident_bytes() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_resident;
+}
+
+std::vector<LexiconRegistry::Status> LexiconRegistry::status() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::vector<Status> out;
+    out.reserve(m_entries.size());
+    for (const Entry &e : m_entries) {
+        const MappedGraph *g = e.graph.get();
+        out.push_back(Status{e.name, e.path, g != nullptr, g ? g->bytes() : 0, g ? g->resident_bytes() : 0,
+                             g ? g->huge_page_bytes() : 0, g && g->residency().locked, e.loads, e.uses, e.error});
+    }
+    return out;
+}
+
+LexiconRegistry::Entry *LexiconRegistry::find(const std::string &name) {
+    for (Entry &e : m_entries)
+        if (e.name == name) return &e;
+    return nullptr;
+}
+
+const LexiconRegistry::Entry *LexiconRegistry::find(const std::string &name) const {
+    for (const Entry &e : m_entries)
+        if (e.name == name) return &e;
+    return nullptr;
+}
+
+void LexiconRegistry::evict(const Entry *keep) {
+    while (m_cap && m_resident > m_cap) {
+        Entry *oldest = nullptr;
+        for (Entry &e : m_entries)
+            if (e.graph && &e != keep && (!oldest || e.last_used < oldest->last_used)) oldest = &e;
+        if (!oldest) return;  // the lexicon in use is over the cap alone
+        m_resident -= oldest->graph->bytes();
+        std::fprintf(stderr, "[lexica] evicted %s (%zu bytes, resident %zu)\n", oldest->name.c_str(),
+                     oldest->graph->bytes(), m_resident);
+        oldest->graph.reset();
+    }
+}
+
+} // namespace wrapper
@@ -0,0 +1,90 @@
+#ifndef GEN_LEXICON_REGISTRY_H
+#define GEN_LEXICON_REGISTRY_H
+
+#include <cstddef>
+#include <cstdint>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "gen/mapped_graph.h"
+#include "gen/residency.h"
+
+namespace wrapper {
+
+// Named mapped GADDAGs that requests pick with their "lexicon" field. A
+// lexicon is mapped on first use and stays resident until the mapped bytes
+// of all resident lexica exceed the cap; the least recently used ones are
+// then dropped. A dropped graph stays mapped for any request still holding
+// it and is unmapped when the last one lets go.
+//
+// Thread-safe. The lock only guards the table: a first use maps and
+// validates the file outside it, so requests for other lexica carry on, and
+// concurrent first uses of one lexicon wait for that single load.
+class LexiconRegistry {
+public:
+    struct Status {
+        std::string name;
+        std::string path;
+        bool resident;
+        size_t bytes;        // mapped size while resident
+        size_t in_memory;    // of those, bytes in RAM now
+        size_t huge_pages;   // of those, bytes on huge pages
+        bool locked;
+        uint64_t loads;      // times the file was mapped
+        uint64_t uses;
+        std::string error;   // last failed load
+    };
+
+    // Each lexicon mapped gets `residency` applied (gen/residency.h)
+    explicit LexiconRegistry(size_t cap_bytes = 0, const ResidencyOptions &residency = ResidencyOptions())
+        : m_cap(cap_bytes), m_residency(residency) {}
+
+    LexiconRegistry(const LexiconRegistry &) = delete;
+    LexiconRegistry &operator=(const LexiconRegistry &) = delete;
+
+    // Registers `name` (up to 32 letters, digits, '_' and '-') for the file at `path`;
+    // nothing is mapped yet. False if the name is malformed or taken.
+    bool add(const std::string &name, const std::string &path);
+
+    bool contains(const std::string &name) const;
+
+    // The graph for `name`, mapped now if it is not resident, or null with
+    // `error` set when it is unknown or does not load
+    std::shared_ptr<const MappedGraph> acquire(const std::string &name, std::string &error);
+
+    size_t cap_bytes() const { return m_cap; }
+    size_t resident_bytes() const;
+    std::vector<Status> status() const;
+
+private:
+    struct Entry {
+        std::string name;
+        std::string path;
+        std::shared_ptr<const MappedGraph> graph;
+        uint64_t last_used = 0;
+        uint64_t loads = 0;
+        uint64_t uses = 0;
+        std::string error;
+        bool loading = false;  // a first use is mapping the file
+    };
+
+    Entry *find(const std::string &name);
+    const Entry *find(const std::string &name) const;
+    // Drops least recently used lexica other than `keep` while over the cap
+    void evict(const Entry *keep);
+
+    size_t m_cap;  // 0 = no cap
+    ResidencyOptions m_residency;
+    mutable std::mutex m_mutex;
+    std::condition_variable m_loaded;  // an entry's loading went false
+    std::vector<Entry> m_entries;  // a handful of lexica: linear scans
+    size_t m_resident = 0;
+    uint64_t m_clock = 0;
+};
+
+} // namespace wrapper
+
+#endif // GEN_LEXICON_REGISTRY_H
@@ -0,0 +1,213 @@
+#include "gen/mapped_graph.h"
+
+#include "gen/atomic_file.h"
+
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace wrapper {
+
+namespace {
+
+MappedGraphHeader expected_header(uint64_t nodes) {
+    MappedGraphHeader h{};
+    std::memcpy(h.magic, kMappedGraphMagic, sizeof(h.magic));
+    h.version = kMappedGraphVersion;
+    h.node_bytes = sizeof(MappedNode);
+    h.nodes = nodes;
+    return h;
+}
+
+MappedGraphHeader compact_header(uint64_t nodes) {
+    MappedGraphHeader h = expected_header(nodes);
+    h.version = kMappedGraphCompactVersion;
+    h.node_bytes = 0;
+    h.index_bits = 1;
+    while (h.index_bits < 32 && (nodes - 1) >> h.index_bits) ++h.index_bits;
+    return h;
+}
+
+// Packed records, padded to whole words so every record is read with one
+// unaligned 8-byte load
+size_t compact_table_bytes(uint64_t nodes, uint32_t index_bits) {
+    const uint64_t bits = nodes * (kMappedCompactFlagBits + index_bits);
+    return static_cast<size_t>((bits + 63) / 64 * 8 + 8);
+}
+
+uint64_t compact_record(const MappedNode &node) {
+    const bool has_children = (node.mask & kMappedLetterMask) != 0;
+    return (node.link >> kMappedLetterShift) |
+           uint64_t((node.mask & kMappedTerminalBit) != 0) << 5 |
+           uint64_t((node.mask & kMappedLastBit) != 0) << 6 |
+           uint64_t(has_children ? node.link & kMappedIndexMask : 0) << kMappedCompactFlagBits;
+}
+
+// The 8-byte table of a compact file, header included, in an anonymous
+// read-only mapping of `table_bytes`; null with `error` set if the file is
+// malformed
+void *expand_compact(const void *map, size_t bytes, size_t &table_bytes, std::string &error) {
+    MappedGraphHeader header;
+    std::memcpy(&header, map, sizeof(header));
+    const uint64_t count = header.nodes;
+    const MappedGraphHeader want = compact_header(count);
+    if (!count || count > kMappedMaxNodes || std::memcmp(&header, &want, sizeof(header)) != 0 ||
+        sizeof(MappedGraphHeader) + compact_table_bytes(count, header.index_bits) != bytes) {
+        error = "header mismatch (format, version or node count)";
+        return nullptr;
+    }
+    table_bytes = sizeof(MappedGraphHeader) + count * sizeof(MappedNode);
+    void *table = ::mmap(nullptr, table_bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (table == MAP_FAILED) {
+        error = "mmap: " + std::string(std::strerror(errno));
+        return nullptr;
+    }
+    const MappedGraphHeader expanded = expected_header(count);
+    std::memcpy(table, &expanded, sizeof(expanded));
+    auto *nodes = reinterpret_cast<MappedNode *>(static_cast<char *>(table) + sizeof(MappedGraphHeader));
+    const auto *packed = static_cast<const unsigned char *>(map) + sizeof(MappedGraphHeader);
+    const uint32_t width = kMappedCompactFlagBits + header.index_bits;
+    const uint64_t field = (uint64_t(1) << width) - 1;
+    for (uint64_t i = 0, bit = 0; i < count; ++i, bit += width) {
+        uint64_t word;
+        std::memcpy(&word, packed + bit / 8, sizeof(word));
+        const uint64_t record = word >> bit % 8 & field;
+        const uint64_t index = record >> kMappedCompactFlagBits;
+        nodes[i].mask = ((record >> 5 & 1) ? kMappedTerminalBit : 0) | ((record >> 6 & 1) ? kMappedLastBit : 0);
+        nodes[i].link = static_cast<uint32_t>(index) | static_cast<uint32_t>(record & 0x1f) << kMappedLetterShift;
+    }
+    // Masks from the child runs; a run that runs off the table leaves its
+    // parent's mask short of the count and fails the check in open()
+    for (uint64_t i = 0; i < count; ++i) {
+        const uint64_t first = nodes[i].link & kMappedIndexMask;
+        if (!first) continue;
+        uint32_t mask = 0;
+        for (uint64_t c = first; c < count; ++c) {
+            mask |= 1u << (nodes[c].link >> kMappedLetterShift);
+            if (nodes[c].mask & kMappedLastBit) break;
+        }
+        nodes[i].mask |= mask & kMappedLetterMask;
+    }
+    ::mprotect(table, table_bytes, PROT_READ);
+    return table;
+}
+
+} // namespace
+
+bool MappedGraph::open(const std::string &path, std::string &error) {
+    close();
+    const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        error = "open: " + std::string(std::strerror(errno));
+        return false;
+    }
+    struct stat st{};
+    if (::fstat(fd, &st) != 0) {
+        error = "fstat: " + std::string(std::strerror(errno));
+        ::close(fd);
+        return false;
+    }
+    size_t bytes = static_cast<size_t>(st.st_size);
+    if (bytes < sizeof(MappedGraphHeader) + sizeof(MappedNode)) {
+        error = "size " + std::to_string(bytes) + " is too small";
+        ::close(fd);
+        return false;
+    }
+    void *map = ::mmap(nullptr, bytes, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (map == MAP_FAILED) {
+        error = "mmap: " + std::string(std::strerror(errno));
+        return false;
+    }
+    if (static_cast<const MappedGraphHeader *>(map)->version == kMappedGraphCompactVersion) {
+        size_t table_bytes = 0;
+        void *table = expand_compact(map, bytes, table_bytes, error);
+        ::munmap(map, bytes);
+        if (!table) return false;
+        map = table;
+        bytes = table_bytes;
+    }
+
+    const size_t count = (bytes - sizeof(MappedGraphHeader)) / sizeof(MappedNode);
+    const MappedGraphHeader want = expected_header(count);
+    const auto *nodes = reinterpret_cast<const MappedNode *>(static_cast<const char *>(map) + sizeof(MappedGraphHeader));
+    if (std::memcmp(map, &want, sizeof(want)) != 0 ||
+        sizeof(MappedGraphHeader) + count * sizeof(MappedNode) != bytes) {
+        error = "header mismatch (format, version or node count)";
+        ::munmap(map, bytes);
+        return false;
+    }
+    // Every run ends before the file does once the last node closes a run,
+    // so child runs that start and (by their mask) end in range are enough
+    // to keep walks inside the map
+    bool valid = count <= kMappedMaxNodes && (nodes[count - 1].mask & kMappedLastBit);
+    for (size_t i = 0; valid && i < count; ++i) {
+        const uint32_t children = __builtin_popcount(nodes[i].mask & kMappedLetterMask);
+        valid = !children || (nodes[i].link & kMappedIndexMask) + children <= count;
+    }
+    if (!valid) {
+        error = "corrupt node table";
+        ::munmap(map, bytes);
+        return false;
+    }
+    m_map = map;
+    m_bytes = bytes;
+    m_nodes = nodes;
+    m_count = count;
+    return true;
+}
+
+void MappedGraph::close() {
+    release_resident(m_map, m_bytes, m_residency);
+    m_map = nullptr;
+    m_bytes = 0;
+    m_nodes = nullptr;
+    m_count = 0;
+    m_residency = Residency();
+}
+
+void MappedGraph::apply_residency(const ResidencyOptions &options) {
+    if (!m_map || !options.any()) return;
+    make_resident(m_map, m_bytes, options, m_residency);
+    m_nodes = reinterpret_cast<const MappedNode *>(static_cast<const char *>(m_map) + sizeof(MappedGraphHeader));
+}
+
+size_t mapped_file_bytes(size_t nodes, bool compact) {
+    return sizeof(MappedGraphHeader) +
+           (compact ? compact_table_bytes(nodes, compact_header(nodes).index_bits) : nodes * sizeof(MappedNode));
+}
+
+bool write_mapped_nodes(const std::string &path, const std::vector<MappedNode> &nodes, std::string &error,
+                        bool compact) {
+    if (nodes.empty() || nodes.size() > kMappedMaxNodes) {
+        error = "node count " + std::to_string(nodes.size()) + " out of range";
+        return false;
+    }
+    return write_file_atomically(path, [&nodes, compact](std::FILE *f) {
+        if (compact) {
+            const MappedGraphHeader header = compact_header(nodes.size());
+            const uint32_t width = kMappedCompactFlagBits + header.index_bits;
+            std::vector<unsigned char> packed(compact_table_bytes(nodes.size(), header.index_bits));
+            uint64_t bit = 0;
+            for (const MappedNode &node : nodes) {
+                uint64_t word;
+                std::memcpy(&word, &packed[bit / 8], sizeof(word));
+                word |= compact_record(node) << bit % 8;
+                std::memcpy(&packed[bit / 8], &word, sizeof(word));
+                bit += width;
+            }
+            return std::fwrite(&header, sizeof(header), 1, f) == 1 &&
+                   std::fwrite(packed.data(), 1, packed.size(), f) == packed.size();
+        }
+        const MappedGraphHeader header = expected_header(nodes.size());
+        return std::fwrite(&header, sizeof(header), 1, f) == 1 &&
+               std::fwrite(nodes.data(), sizeof(MappedNode), nodes.size(), f) == nodes.size();
+    }, error);
+}
+
+} // namespace wrapper
@@ -0,0 +1,195 @@
+#ifndef GEN_MAPPED_GRAPH_H
+#define GEN_MAPPED_GRAPH_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "gen/residency.h"
+
+namespace wrapper {
+
+// GADDAG in a flat file that is memory-mapped read-only and walked in
+// place: no decoding at startup, and every process on the host shares the
+// page-cache copy. Written by tools/mapgaddag from a Quackle .gaddag, or by
+// tools/makegaddag --mapped from a word list.
+//
+// Each node is 8 bytes: a bitmask of its children's letters and the index
+// of its first child. Children are a contiguous run sorted by letter, so the
+// child for a letter is one mask test and a popcount away, with no sibling
+// scan. Runs are laid out breadth-first; a run that fits in a 64-byte line
+// never straddles two, so each level of a walk costs at most one cache miss.
+// Shared runs are stored once. Node 0 is the root; no node points back to
+// it, so a child index of 0 means "no children".
+struct MappedNode {
+    uint32_t mask;  // bit l: a child with letter l (0 = separator); flags above
+    uint32_t link;  // first child index, and this node's own letter on top
+};
+
+static_assert(sizeof(MappedNode) == 8, "mapped nodes pack 8 to a cache line");
+
+constexpr uint32_t kMappedLetterMask = 0x3fffffffu;  // separator + up to 29 letters
+constexpr uint32_t kMappedTerminalBit = 1u << 30;
+constexpr uint32_t kMappedLastBit = 1u << 31;
+constexpr uint32_t kMappedIndexMask = 0x07ffffffu;
+constexpr int kMappedLetterShift = 27;
+constexpr uint32_t kMappedMaxNodes = kMappedIndexMask + 1;
+constexpr size_t kMappedLineNodes = 64 / sizeof(MappedNode);
+
+inline MappedNode mapped_node(uint32_t children, uint32_t first_child, uint8_t letter, bool terminal, bool last) {
+    return MappedNode{children | (terminal ? kMappedTerminalBit : 0) | (last ? kMappedLastBit : 0),
+                      first_child | static_cast<uint32_t>(letter & 0x1f) << kMappedLetterShift};
+}
+
+// 64 bytes, so the node table starts on a cache line in the mapping
+struct MappedGraphHeader {
+    char magic[8];     // "WGADDAG\0"
+    uint32_t version;
+    uint32_t node_bytes;
+    uint64_t nodes;
+    uint32_t index_bits;  // compact files: width of a child index
+    uint8_t reserved[36];
+};
+
+static_assert(sizeof(MappedGraphHeader) == 64, "node table must start on a cache line");
+
+constexpr char kMappedGraphMagic[8] = {'W', 'G', 'A', 'D', 'D', 'A', 'G', 0};
+constexpr uint32_t kMappedGraphVersion = 2;
+
+// Compact files drop the masks (a node's mask is the letters of its child
+// run) and store each node as letter, terminal, last and a child index only
+// as wide as the node count needs, bit-packed. open() expands them into the
+// 8-byte table above, in memory rather than shared through the page cache.
+constexpr uint32_t kMappedGraphCompactVersion = 3;
+constexpr uint32_t kMappedCompactFlagBits = 7;  // letter (5), terminal, last
+
+// Graph view of a mapped file, same interface as QuackleGaddag
+class MappedGraph {
+public:
+    using Node = const MappedNode *;
+
+    MappedGraph() = default;
+    ~MappedGraph() { close(); }
+
+    MappedGraph(const MappedGraph &) = delete;
+    MappedGraph &operator=(const MappedGraph &) = delete;
+
+    // Checks the header and every child index once, so later walks never
+    // leave the mapping. On failure `error` says why and the view stays
+    // unloaded.
+    bool open(const std::string &path, std::string &error);
+    void close();
+
+    // Copies, places or locks the node table per `options` (gen/residency.h);
+    // the view keeps working whatever does not take
+    void apply_residency(const ResidencyOptions &options);
+
+    bool loaded() const { return m_nodes != nullptr; }
+    size_t bytes() const { return m_bytes; }
+    size_t node_count() const { return m_count; }
+    const Residency &residency() const { return m_residency; }
+    size_t resident_bytes() const { return wrapper::resident_bytes(m_map, m_bytes); }
+    size_t huge_page_bytes() const { return wrapper::huge_page_bytes(m_map, m_bytes, m_residency); }
+
+    Node root() const { return m_nodes; }
+    Node first_child(Node node) const {
+        return node->mask & kMappedLetterMask ? m_nodes + (node->link & kMappedIndexMask) : nullptr;
+    }
+    Node next_sibling(Node node) const { return node->mask & kMappedLastBit ? nullptr : node + 1; }
+    uint8_t letter(Node node) const { return static_cast<uint8_t>(node->link >> kMappedLetterShift); }
+    bool terminal(Node node) const { return (node->mask & kMappedTerminalBit) != 0; }
+    Node child(Node node, uint8_t letter) const {
+        const uint32_t bit = 1u << letter;
+        if (!(node->mask & bit)) return nullptr;
+        return m_nodes + (node->link & kMappedIndexMask) + __builtin_popcount(node->mask & (bit - 1));
+    }
+
+private:
+    void *m_map = nullptr;
+    size_t m_bytes = 0;
+    const MappedNode *m_nodes = nullptr;
+    size_t m_count = 0;
+    Residency m_residency;
+};
+
+// Writes packed nodes (root first) under the mapped-graph header, compact
+// or as the 8-byte table
+bool write_mapped_nodes(const std::string &path, const std::vector<MappedNode> &nodes, std::string &error,
+                        bool compact = false);
+
+// Size of the file write_mapped_nodes writes for `nodes` nodes
+size_t mapped_file_bytes(size_t nodes, bool compact);
+
+// Packs any graph with the generator's interface. Sibling runs are keyed by
+// their first node in the source, so a DAG keeps its sharing; Node must be
+// hashable.
+template <class Graph>
+bool pack_graph(const Graph &graph, std::vector<MappedNode> &nodes, std::string &error) {
+    using Node = typename Graph::Node;
+    using Run = std::vector<std::pair<uint8_t, Node>>;
+    nodes.assign(1, MappedNode{0, 0});
+    std::unordered_map<Node, uint32_t> run_at;
+    std::deque<std::pair<Node, uint32_t>> pending;
+    bool letters_ok = true;
+
+    // The run starting at `first`, sorted by letter; returns the letter mask
+    auto sorted_run = [&](Node first, Run &run) {
+        run.clear();
+        uint32_t mask = 0;
+        for (Node n = first; n; n = graph.next_sibling(n)) {
+            const uint8_t letter = graph.letter(n);
+            if (!(1u << letter & kMappedLetterMask)) letters_ok = false;
+            run.emplace_back(letter, n);
+            mask |= 1u << letter;
+        }
+        std::sort(run.begin(), run.end(), [](const auto &a, const auto &b) { return a.first < b.first; });
+        return mask & kMappedLetterMask;
+    };
+    auto place_run = [&](Node first, size_t length) -> uint32_t {
+        if (!first) return 0;
+        auto it = run_at.find(first);
+        if (it != run_at.end()) return it->second;
+        // A run that fits in a line starts on a fresh one rather than straddle two
+        size_t at = nodes.size();
+        if (length <= kMappedLineNodes && at % kMappedLineNodes + length > kMappedLineNodes)
+            at += kMappedLineNodes - at % kMappedLineNodes;
+        nodes.resize(at + length, MappedNode{0, 0});
+        run_at.emplace(first, static_cast<uint32_t>(at));
+        pending.emplace_back(first, static_cast<uint32_t>(at));
+        return static_cast<uint32_t>(at);
+    };
+
+    Run run, children;
+    const Node top = graph.first_child(graph.root());
+    const uint32_t top_mask = sorted_run(top, children);
+    nodes[0] = mapped_node(top_mask, place_run(top, children.size()), 0, graph.terminal(graph.root()), true);
+    while (!pending.empty() && nodes.size() <= kMappedMaxNodes) {
+        const auto placed = pending.front();
+        pending.pop_front();
+        sorted_run(placed.first, run);
+        for (size_t i = 0; i < run.size(); ++i) {
+            const Node n = run[i].second;
+            const Node first = graph.first_child(n);
+            const uint32_t mask = sorted_run(first, children);
+            nodes[placed.second + i] = mapped_node(mask, place_run(first, children.size()), run[i].first,
+                                                   graph.terminal(n), i + 1 == run.size());
+        }
+    }
+    if (!letters_ok) {
+        error = "letter outside the " + std::to_string(__builtin_popcount(kMappedLetterMask)) + "-bit child mask";
+        return false;
+    }
+    if (nodes.size() > kMappedMaxNodes) {
+        error = "more than " + std::to_string(kMappedMaxNodes) + " nodes";
+        return false;
+    }
+    return true;
+}
+
+} // namespace wrapper
+
+#endif // GEN_MAPPED_GRAPH_H
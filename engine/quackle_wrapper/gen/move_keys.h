@@ -0,0 +1,79 @@
+#ifndef GEN_MOVE_KEYS_H
+#define GEN_MOVE_KEYS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace wrapper {
+
+// Open-addressing set of 64-bit move keys (see candidate_key). Slots carry
+// the epoch they were written in, so clear() is O(1) and keeps the table:
+// a set that lives across requests stops allocating once it has grown to
+// the largest request seen. Key 0 is never a valid move key.
+class MoveKeySet {
+public:
+    MoveKeySet() { m_slots.resize(kInitialSlots); }
+
+    void clear() {
+        m_size = 0;
+        if (++m_epoch == 0) {  // wrapped: stale stamps could look current
+            for (Slot &s : m_slots) s.epoch = 0;
+            m_epoch = 1;
+        }
+    }
+
+    size_t size() const { return m_size; }
+
+    // False if the key was already present
+    bool insert(uint64_t key) {
+        if ((m_size + 1) * 2 > m_slots.size()) grow();
+        return place(key);
+    }
+
+private:
+    static constexpr size_t kInitialSlots = 256;
+
+    struct Slot {
+        uint64_t key = 0;
+        uint32_t epoch = 0;
+    };
+
+    static uint64_t mix(uint64_t k) {
+        k ^= k >> 33;
+        k *= 0xff51afd7ed558ccdULL;
+        k ^= k >> 33;
+        return k;
+    }
+
+    bool place(uint64_t key) {
+        const size_t mask = m_slots.size() - 1;
+        for (size_t i = mix(key) & mask;; i = (i + 1) & mask) {
+            Slot &s = m_slots[i];
+            if (s.epoch != m_epoch) {
+                s.key = key;
+                s.epoch = m_epoch;
+                ++m_size;
+                return true;
+            }
+            if (s.key == key) return false;
+        }
+    }
+
+    void grow() {
+        std::vector<Slot> old;
+        old.swap(m_slots);
+        m_slots.resize(old.size() * 2);
+        m_size = 0;
+        for (const Slot &s : old)
+            if (s.epoch == m_epoch) place(s.key);
+    }
+
+    std::vector<Slot> m_slots;
+    size_t m_size = 0;
+    uint32_t m_epoch = 1;
+};
+
+} // namespace wrapper
+
+#endif // GEN_MOVE_KEYS_H
@@ -0,0 +1,105 @@
+#ifndef GEN_MOVE_STORE_H
+#define GEN_MOVE_STORE_H
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "gen/candidate.h"
+
+namespace wrapper {
+
+// Full sorted move lists kept between requests, so a client can page through
+// every play without regenerating. Each list is reached by an opaque cursor
+// and dropped once it has gone unused for the TTL. The store is bounded by
+// entry count and by total candidates (24 bytes each on the standard board);
+// the least recently used lists make room for new ones.
+//
+// Not thread-safe: owned by the serving loop.
+template <int Dim>
+class BasicMoveStore {
+public:
+    using Clock = std::chrono::steady_clock;
+    using Candidate = BasicCandidate<Dim>;
+
+    BasicMoveStore(size_t max_entries, size_t max_moves, Clock::duration ttl)
+        : m_max_entries(max_entries), m_max_moves(max_moves), m_ttl(ttl), m_rng(std::random_device{}()) {}
+
+    // Keeps `moves` (best first) and returns its cursor, or an empty string
+    // if the list alone is over the move budget
+    std::string put(std::vector<Candidate> &&moves, Clock::time_point now = Clock::now()) {
+        expire(now);
+        if (moves.size() > m_max_moves || m_max_entries == 0) return std::string();
+        while (!m_entries.empty() && (m_entries.size() >= m_max_entries || m_moves + moves.size() > m_max_moves))
+            evict_oldest();
+
+        std::string cursor;
+        do {
+            char buf[17];
+            std::snprintf(buf, sizeof(buf), "%016llx", static_cast<unsigned long long>(m_rng()));
+            cursor = buf;
+        } while (m_entries.count(cursor));
+        m_moves += moves.size();
+        m_entries.emplace(cursor, Entry{std::move(moves), now});
+        return cursor;
+    }
+
+    // The list behind `cursor`, or null once it expired or was evicted. A
+    // hit restarts the cursor's TTL.
+    const std::vector<Candidate> *get(const std::string &cursor, Clock::time_point now = Clock::now()) {
+        expire(now);
+        auto it = m_entries.find(cursor);
+        if (it == m_entries.end()) return nullptr;
+        it->second.last_used = now;
+        return &it->second.moves;
+    }
+
+    size_t entries() const { return m_entries.size(); }
+    size_t moves() const { return m_moves; }
+    Clock::duration ttl() const { return m_ttl; }
+
+private:
+    struct Entry {
+        std::vector<Candidate> moves;
+        Clock::time_point last_used;
+    };
+
+    void expire(Clock::time_point now) {
+        for (auto it = m_entries.begin(); it != m_entries.end();) {
+            if (now - it->second.last_used < m_ttl) {
+                ++it;
+                continue;
+            }
+            m_moves -= it->second.moves.size();
+            it = m_entries.erase(it);
+        }
+    }
+
+    // Linear scan: the entry bound is small and eviction only runs on a put
+    void evict_oldest() {
+        auto oldest = m_entries.begin();
+        for (auto it = m_entries.begin(); it != m_entries.end(); ++it)
+            if (it->second.last_used < oldest->second.last_used) oldest = it;
+        m_moves -= oldest->second.moves.size();
+        m_entries.erase(oldest);
+    }
+
+    size_t m_max_entries;
+    size_t m_max_moves;
+    Clock::duration m_ttl;
+    std::mt19937_64 m_rng;
+    std::unordered_map<std::string, Entry> m_entries;
+    size_t m_moves = 0;
+};
+
+using MoveStore = BasicMoveStore<kBoardDim>;
+
+} // namespace wrapper
+
+#endif // GEN_MOVE_STORE_H
@@ -0,0 +1,525 @@
+#ifndef GEN_MOVEGEN_H
+#define GEN_MOVEGEN_H
+
+#include <algorithm>
+#include <array>
+#include <memory_resource>
+#include <vector>
+
+#include "gen/arena.h"
+#include "gen/board_state.h"
+#include "gen/candidate.h"
+#include "gen/constraints.h"
+#include "gen/leaves.h"
+#include "gen/rack.h"
+#include "gen/rules.h"
+#include "gen/score_bound.h"
+#include "gen/top_k.h"
+#include "gen/work_pool.h"
+
+namespace wrapper {
+
+// Gordon's GADDAG algorithm restricted to one line of the board. Every play
+// is generated from the leftmost anchor it covers, so lines (and directions)
+// are independent of each other once cross-sets are known.
+//
+// Graph requirements: Node (nullable handle), root(), child(node, letter),
+// first_child(node), next_sibling(node), letter(node), terminal(node).
+template <class Graph, int Dim = kBoardDim>
+class MoveGenerator {
+public:
+    using Node = typename Graph::Node;
+    using Board = BasicBoardState<Dim>;
+    using Candidate = BasicCandidate<Dim>;
+
+    // Without `leaves` candidates are ranked by score alone and no leave is
+    // ever looked up; without `constraints` every legal play is generated
+    MoveGenerator(const Graph &graph, const Board &board, const BasicRules<Dim> &rules, const LeaveTable *leaves,
+                  const GenConstraints *constraints = nullptr)
+        : m_graph(graph), m_board(board), m_rules(rules), m_leaves(leaves), m_constraints(constraints) {}
+
+    // With a `bound`, branches that cannot beat the worst of a full `out`
+    // are abandoned; the kept top-K is the same either way.
+    void generate_line(int dir, int line, const RackCounts &rack, BasicTopK<Dim> &out,
+                       const BasicLineBound<Dim> *bound = nullptr) {
+        m_dir = dir;
+        m_line = line;
+        m_rack = rack;
+        m_placed = 0;
+        m_partial = PartialScore();
+        m_partial_all_real = PartialScore();
+        m_leave_index = m_leaves ? m_leaves->index_of(rack) : 0;
+        m_rack_leave_index = m_leave_index;
+        m_blanks_used = 0;
+        m_blank_designations = rack.blanks > 0;
+        m_out = &out;
+        m_bound = out.limit() > 0 ? bound : nullptr;
+        if (m_constraints) start_constraints();
+        for (int pos = 0; pos < Dim; ++pos) {
+            if (!square(pos).anchor) continue;
+            m_anchor = pos;
+            gen(pos, m_graph.root());
+        }
+        flush();
+    }
+
+private:
+    const Square &square(int pos) const { return m_board.at(m_dir, m_line, pos); }
+
+    void gen(int pos, Node node) {
+        if (m_constraints && !reachable(pos)) return;
+        const Square &sq = square(pos);
+        if (sq.tile) {
+            Node next = m_graph.child(node, tile_letter(sq.tile));
+            if (next) go_on(pos, sq.tile | kThroughBit, next);
+            return;
+        }
+        if (m_rack.empty()) return;
+        if (m_bound && m_out->full()) {
+            // Left of the anchor the play may still grow either way
+            const int from = pos > m_anchor ? pos : 0;
+            // With blanks, the bound must cover every designation of the play
+            // (see record_designations): no placed tile scored as a blank,
+            // and any leave of the rack without the blanks used so far
+            const PartialScore &partial = m_blank_designations ? m_partial_all_real : m_partial;
+            const int leave_index = m_blank_designations
+                                        ? m_rack_leave_index - m_blanks_used * leave_stride(kSeparator)
+                                        : m_leave_index;
+            const double leave_bound = m_leaves ? m_leaves->best_within_at(leave_index) : 0.0;
+            if (equity_fixed(m_bound->score(partial, m_placed, m_rack.size, from) + leave_bound) <
+                m_out->worst().equity)
+                return;
+        }
+
+        for (Node child = m_graph.first_child(node); child; child = m_graph.next_sibling(child)) {
+            const uint8_t letter = m_graph.letter(child);
+            if (letter == kSeparator || !(sq.cross >> letter & 1u)) continue;
+            const bool wanted = m_missing[letter] > 0;
+            if (wanted) {
+                --m_missing[letter];
+                --m_need;
+            }
+            if (m_rack.counts[letter]) {
+                const int stride = leave_stride(letter);
+                --m_rack.counts[letter];
+                --m_rack.size;
+                ++m_placed;
+                m_leave_index -= stride;
+                go_on(pos, letter, child);
+                m_leave_index += stride;
+                --m_placed;
+                ++m_rack.size;
+                ++m_rack.counts[letter];
+            }
+            // A blank stands in only for letters the rack has run out of;
+            // other designations are derived when the play is recorded
+            if (m_rack.blanks && !m_rack.counts[letter]) {
+                const int stride = leave_stride(kSeparator);
+                --m_rack.blanks;
+                --m_rack.size;
+                ++m_placed;
+                ++m_blanks_used;
+                m_leave_index -= stride;
+                go_on(pos, letter | kBlankBit, child);
+                m_leave_index += stride;
+                --m_blanks_used;
+                --m_placed;
+                ++m_rack.size;
+                ++m_rack.blanks;
+            }
+            if (wanted) {
+                ++m_missing[letter];
+                ++m_need;
+            }
+        }
+    }
+
+    void go_on(int pos, uint8_t tile, Node next) {
+        const PartialScore saved = m_partial;
+        const PartialScore saved_all_real = m_partial_all_real;
+        m_word[pos] = tile;
+        add_score(pos, tile);
+        if (pos <= m_anchor) {
+            const bool left_free = pos == 0 || !square(pos - 1).tile;
+            const bool right_free = m_anchor + 1 == Dim || !square(m_anchor + 1).tile;
+            if (m_graph.terminal(next) && left_free && right_free) record(pos, m_anchor);
+            // Never walk onto an empty anchor: that anchor owns those plays
+            if (pos > 0 && (square(pos - 1).tile || !square(pos - 1).anchor)) gen(pos - 1, next);
+            // Right of the anchor the start is fixed; it must not pass the
+            // square the play has to cover
+            if (left_free && m_anchor + 1 < Dim && !(m_cover >= 0 && m_cover < pos)) {
+                Node sep = m_graph.child(next, kSeparator);
+                if (sep) {
+                    m_start = pos;
+                    gen(m_anchor + 1, sep);
+                }
+            }
+        } else {
+            const bool right_free = pos + 1 == Dim || !square(pos + 1).tile;
+            if (m_graph.terminal(next) && right_free) record(m_start, pos);
+            if (pos + 1 < Dim) gen(pos + 1, next);
+        }
+        m_partial = saved;
+        m_partial_all_real = saved_all_real;
+    }
+
+    int leave_stride(uint8_t letter) const { return m_leaves ? m_leaves->stride(letter) : 0; }
+
+    void add_score(int pos, uint8_t tile) {
+        const int letter_face = m_rules.tile_score[tile_letter(tile)];
+        const int face = tile_is_blank(tile) ? 0 : letter_face;
+        if (tile_is_through(tile)) {
+            m_partial.main += face;
+            m_partial_all_real.main += face;
+            return;
+        }
+        const int row = Board::row_of(m_dir, m_line, pos);
+        const int col = Board::col_of(m_dir, m_line, pos);
+        const int lm = m_rules.letter_mult[row][col];
+        const int wm = m_rules.word_mult[row][col];
+        const Square &sq = square(pos);
+        m_letter_mult[pos] = lm;
+        m_cross_mult[pos] = sq.has_cross ? lm * wm : 0;
+        m_partial.main += face * lm;
+        m_partial.word_mult *= wm;
+        if (sq.has_cross) m_partial.cross += (sq.cross_score + face * lm) * wm;
+        if (m_blank_designations) {
+            m_partial_all_real.main += letter_face * lm;
+            m_partial_all_real.word_mult *= wm;
+            if (sq.has_cross) m_partial_all_real.cross += (sq.cross_score + letter_face * lm) * wm;
+        }
+    }
+
+    void record(int start, int end) {
+        if (m_constraints && !satisfies(start, end)) return;
+        const int score = m_partial.main * m_partial.word_mult + m_partial.cross +
+                          (m_placed == m_rules.rack_size ? m_rules.bingo_bonus : 0);
+        if (m_blank_designations) record_designations(start, end, score);
+        else emit(start, end, 0, score, m_leave_index);
+    }
+
+    // Every way of playing the recorded letters with the rack's blanks. The
+    // walk found the play once, with a blank only where the rack had run out
+    // of that letter; any other choice of blank squares is valid if it still
+    // covers those shortfalls. Score and leave of each choice follow from the
+    // squares' multipliers without walking the graph again, and a choice is
+    // only built if it would make the heap.
+    void record_designations(int start, int end, int score) {
+        int square_of[Dim];
+        int letter_of[Dim];
+        int value_of[Dim];       // score lost when the tile there is a blank
+        uint32_t same[Dim];      // placed tiles with the same letter
+        uint32_t walked = 0;     // blanks as the walk placed them
+        int n = 0;
+        int all_real_score = score;
+        int all_real_index = m_leave_index;
+        const int blank_stride = leave_stride(kSeparator);
+        for (int pos = start; pos <= end; ++pos) {
+            const uint8_t tile = m_word[pos];
+            if (tile_is_through(tile)) continue;
+            const int letter = tile_letter(tile);
+            square_of[n] = pos;
+            letter_of[n] = letter;
+            value_of[n] = m_rules.tile_score[letter] * (m_letter_mult[pos] * m_partial.word_mult + m_cross_mult[pos]);
+            if (tile_is_blank(tile)) {
+                walked |= 1u << n;
+                all_real_score += value_of[n];
+                all_real_index += blank_stride - leave_stride(static_cast<uint8_t>(letter));
+            }
+            ++n;
+        }
+        for (int i = 0; i < n; ++i) {
+            same[i] = 0;
+            for (int j = 0; j < n; ++j)
+                if (letter_of[j] == letter_of[i]) same[i] |= 1u << j;
+        }
+
+        const int32_t *leave = m_leaves ? m_leaves->fixed_values() : nullptr;
+        constexpr int32_t scale = static_cast<int32_t>(kEquityScale);
+        const int blanks = std::min(m_rack.blanks + __builtin_popcount(walked), n);
+        for (int k = 0; k <= blanks; ++k) {
+            // Subsets of k placed tiles in increasing order (Gosper's hack)
+            for (uint32_t chosen = (1u << k) - 1; chosen < (1u << n);) {
+                bool covers = true;
+                for (uint32_t w = walked; w && covers; w &= w - 1) {
+                    const int i = __builtin_ctz(w);
+                    covers = __builtin_popcount(chosen & same[i]) >= __builtin_popcount(walked & same[i]);
+                }
+                if (covers) {
+                    int variant_score = all_real_score;
+                    int variant_index = all_real_index - k * blank_stride;
+                    uint32_t squares = 0;
+                    for (uint32_t c = chosen; c; c &= c - 1) {
+                        const int i = __builtin_ctz(c);
+                        variant_score -= value_of[i];
+                        variant_index += leave_stride(static_cast<uint8_t>(letter_of[i]));
+                        squares |= 1u << square_of[i];
+                    }
+                    const int32_t equity = variant_score * scale + (leave ? leave[variant_index] : 0);
+                    if (!m_out->full() || equity >= m_out->worst().equity)
+                        emit(start, end, squares, variant_score, variant_index);
+                }
+                if (k == 0) break;
+                const uint32_t low = chosen & -chosen;
+                const uint32_t next = chosen + low;
+                chosen = (((next ^ chosen) >> 2) / low) | next;
+            }
+        }
+    }
+
+    // Queues one play from m_word; `blank_squares` marks the placed tiles
+    // that are blanks (bit per position), overriding the walk's choice
+    void emit(int start, int end, uint32_t blank_squares, int score, int leave_index) {
+        Candidate &c = m_batch[m_batch_size];
+        c = Candidate();
+        c.set_placement(Board::row_of(m_dir, m_line, start), Board::col_of(m_dir, m_line, start),
+                        m_dir == 0, end - start + 1);
+        c.placed = static_cast<uint8_t>(m_placed);
+        for (int pos = start; pos <= end; ++pos) {
+            uint8_t tile = m_word[pos];
+            if (!tile_is_through(tile))
+                tile = static_cast<uint8_t>(tile_letter(tile) | (blank_squares >> pos & 1u ? kBlankBit : 0));
+            c.set_tile(pos - start, tile);
+        }
+        c.score = static_cast<int16_t>(score);
+        if (m_dir == 1 && m_placed == 1) as_horizontal_single(c);
+        m_batch_score[m_batch_size] = c.score;
+        m_batch_leave[m_batch_size] = leave_index;
+        if (++m_batch_size == kBatch) flush();
+    }
+
+    void start_constraints() {
+        const GenConstraints &c = *m_constraints;
+        m_cover = c.has_cover() && (m_dir == 0 ? c.cover_row : c.cover_col) == m_line
+                      ? (m_dir == 0 ? c.cover_col : c.cover_row)
+                      : -1;
+        m_need = 0;
+        for (int l = 0; l < kMaxLetters; ++l) {
+            m_missing[l] = c.must_use.counts[l];
+            m_need += m_missing[l];
+        }
+        m_empty_from[Dim] = 0;
+        for (int pos = Dim - 1; pos >= 0; --pos) m_empty_from[pos] = m_empty_from[pos + 1] + !square(pos).tile;
+    }
+
+    // Whether a play that has reached `pos` can still be completed within
+    // the constraints. Left of the anchor the word spans [pos, anchor] and
+    // may grow both ways; right of it, [m_start, pos] and only grows right.
+    bool reachable(int pos) const {
+        const GenConstraints &c = *m_constraints;
+        const bool left = pos <= m_anchor;
+        const int length = left ? m_anchor - pos + 1 : pos - m_start + 1;
+        if (c.max_length && length > c.max_length) return false;
+        if (m_need > m_rack.size) return false;
+        if (c.use_all) {
+            const int empties = left ? m_empty_from[0] - m_empty_from[pos + 1] + m_empty_from[m_anchor + 1]
+                                     : m_empty_from[pos];
+            if (empties < m_rack.size) return false;
+        }
+        return true;
+    }
+
+    bool satisfies(int start, int end) const {
+        const GenConstraints &c = *m_constraints;
+        const int length = end - start + 1;
+        if (length < c.min_length || (c.max_length && length > c.max_length)) return false;
+        if (c.has_cover() && (m_cover < start || m_cover > end)) return false;
+        if (m_need > 0) return false;
+        return !c.use_all || m_rack.empty();
+    }
+
+    // Equity for a block of recorded candidates in one pass over flat score
+    // and leave-index arrays: a multiply-add and a gather from the leave
+    // table per candidate, with no per-move lookups or branches. The heap
+    // sees the block late, which only makes pruning slightly less eager.
+    void flush() {
+        const int n = m_batch_size;
+        const int32_t *leave = m_leaves ? m_leaves->fixed_values() : nullptr;
+        constexpr int32_t scale = static_cast<int32_t>(kEquityScale);
+        int32_t equity[kBatch];
+        if (leave) {
+            for (int i = 0; i < n; ++i) equity[i] = m_batch_score[i] * scale + leave[m_batch_leave[i]];
+        } else {
+            for (int i = 0; i < n; ++i) equity[i] = m_batch_score[i] * scale;
+        }
+        for (int i = 0; i < n; ++i) {
+            m_batch[i].equity = equity[i];
+            m_out->push(m_batch[i]);
+        }
+        m_batch_size = 0;
+    }
+
+    // A single tile that also forms a horizontal word is found once per
+    // direction with the same score; rewrite the vertical copy as the
+    // horizontal one so both share a key and the second is dropped on insert
+    void as_horizontal_single(Candidate &c) const {
+        int row = c.row;
+        const int col = c.col;
+        uint8_t tile = 0;
+        for (int i = 0; i < c.length(); ++i) {
+            if (tile_is_through(c.tile(i))) continue;
+            row = c.row + i;
+            tile = c.tile(i);
+            break;
+        }
+        if (!m_board.at(1, col, row).has_cross) return;
+
+        int first = col;
+        while (first > 0 && m_board.tile(row, first - 1)) --first;
+        int last = col;
+        while (last + 1 < Dim && m_board.tile(row, last + 1)) ++last;
+        Candidate h;
+        h.set_placement(row, first, true, last - first + 1);
+        for (int x = first; x <= last; ++x)
+            h.set_tile(x - first, x == col ? tile : static_cast<uint8_t>(m_board.tile(row, x) | kThroughBit));
+        h.placed = c.placed;
+        h.score = c.score;
+        // Under constraints the across word may not qualify; the down copy
+        // then stands alone, as its across twin was never generated
+        if (m_constraints && !m_constraints->allows_word(h.row, h.col, true, h.length())) return;
+        c = h;
+    }
+
+    const Graph &m_graph;
+    const Board &m_board;
+    const BasicRules<Dim> &m_rules;
+    const LeaveTable *m_leaves;
+    const GenConstraints *m_constraints;
+
+    int m_dir = 0;
+    int m_line = 0;
+    int m_anchor = 0;
+    int m_start = 0;
+    int m_placed = 0;
+    RackCounts m_rack;
+    uint8_t m_word[Dim] = {};
+    PartialScore m_partial;
+    PartialScore m_partial_all_real;  // as if no placed tile were a blank
+    int m_letter_mult[Dim] = {};
+    int m_cross_mult[Dim] = {};       // letter times word multiplier where a cross word forms
+    int m_leave_index = 0;            // index of m_rack in the leave table
+    int m_rack_leave_index = 0;       // index of the whole rack
+    int m_blanks_used = 0;
+    bool m_blank_designations = false;
+    BasicTopK<Dim> *m_out = nullptr;
+    const BasicLineBound<Dim> *m_bound = nullptr;
+
+    // Constraint state; m_missing stays all zero without constraints
+    int m_cover = -1;                   // position on this line to cover, or -1
+    int m_need = 0;                     // must-use letters not placed yet
+    uint8_t m_missing[kMaxLetters] = {};
+    int m_empty_from[Dim + 1] = {};     // empty squares in [pos, Dim)
+
+    // Recorded candidates waiting for equity, structure-of-arrays
+    static constexpr int kBatch = 16;
+    Candidate m_batch[kBatch];
+    int32_t m_batch_score[kBatch];
+    int32_t m_batch_leave[kBatch];
+    int m_batch_size = 0;
+};
+
+enum class RankBy {
+    Equity,  // score plus leave value
+    Score,   // score only; the leave table is never read
+};
+
+struct GenOptions {
+    int top_n = 10;      // <= 0 keeps every play
+    bool prune = false;  // score-bound pruning against the current K-th best
+    RankBy rank_by = RankBy::Equity;
+    GenConstraints constraints;  // plays outside these are never generated
+};
+
+// Scratch state reused across requests: per-worker heaps and key sets, line
+// bounds, and an arena for the per-request results. A caller that keeps one
+// alive per serving thread stops allocating once it has seen its largest
+// request; it rewinds the arena after each reply.
+template <int Dim>
+struct BasicGenWorkspace {
+    RequestArena arena;
+    std::vector<BasicTopK<Dim>> best;
+    std::vector<BasicLineBound<Dim>> bounds;
+};
+
+using GenWorkspace = BasicGenWorkspace<kBoardDim>;
+
+// Generates every legal placement and returns the best `top_n` by equity (or
+// by score, see RankBy), best first, allocated from the workspace arena. With a pool, each
+// (direction, line) is one task; every worker keeps its own bounded heap and
+// the heaps are merged at the end. Ranking is a total order, so the result
+// does not depend on the number of threads or on scheduling.
+template <class Graph, int Dim>
+std::pmr::vector<BasicCandidate<Dim>> generate_moves(const Graph &graph, const BasicBoardState<Dim> &board,
+                                                     const BasicRules<Dim> &rules, const RackCounts &rack,
+                                                     const LeaveTable &leaves, WorkPool *pool,
+                                                     const GenOptions &options, BasicGenWorkspace<Dim> &ws) {
+    struct LineTask {
+        int dir = 0;
+        int line = 0;
+        int bound = 0;  // score bound of the whole line, when pruning
+    };
+    const GenConstraints *constraints = options.constraints.any() ? &options.constraints : nullptr;
+    // An opening on a board symmetric about its diagonal is generated across
+    // only: every down play is the mirror image of an across one with the
+    // same score and leave. A square to cover off the diagonal breaks that.
+    const bool mirror_opening =
+        board.empty() && rules.symmetric_about_diagonal() &&
+        (!constraints || (constraints->allows_direction(0) && constraints->cover_row == constraints->cover_col));
+    std::array<LineTask, 2 * Dim> tasks;
+    int task_count = 0;
+    for (int dir = 0; dir < 2; ++dir) {
+        if (constraints && !constraints->allows_direction(dir)) continue;
+        if (dir == 1 && mirror_opening) continue;
+        for (int line = 0; line < Dim; ++line) {
+            if (constraints && constraints->has_cover() &&
+                line != (dir == 0 ? constraints->cover_row : constraints->cover_col))
+                continue;
+            if (board.line_has_anchor(dir, line)) tasks[task_count++] = LineTask{dir, line, 0};
+        }
+    }
+
+    // Pruning: most promising lines first so the K-th best rises early.
+    // Bounds are indexed by (dir, line) so sorting the tasks leaves them put.
+    if (options.prune) {
+        if (ws.bounds.size() < tasks.size()) ws.bounds.resize(tasks.size());
+        for (int t = 0; t < task_count; ++t) {
+            BasicLineBound<Dim> &bound = ws.bounds[tasks[t].dir * Dim + tasks[t].line];
+            bound.build(board, rules, rack, tasks[t].dir, tasks[t].line);
+            tasks[t].bound = bound.score(PartialScore(), 0, rack.size, 0);
+        }
+        // Stable insertion sort: at most 30 lines, and no temporary buffer
+        for (int t = 1; t < task_count; ++t) {
+            const LineTask moving = tasks[t];
+            int i = t;
+            for (; i > 0 && tasks[i - 1].bound < moving.bound; --i) tasks[i] = tasks[i - 1];
+            tasks[i] = moving;
+        }
+    }
+
+    const size_t limit = options.top_n > 0 ? static_cast<size_t>(options.top_n) : 0;
+    const int workers = pool && pool->size() > 1 ? pool->size() : 1;
+    std::vector<BasicTopK<Dim>> &best = ws.best;
+    if (static_cast<int>(best.size()) < workers) best.resize(workers);
+    for (int w = 0; w < workers; ++w) best[w].reset(limit);
+    const LeaveTable *leave_table = options.rank_by == RankBy::Score ? nullptr : &leaves;
+    auto run_task = [&](int task, int worker) {
+        MoveGenerator<Graph, Dim> gen(graph, board, rules, leave_table, constraints);
+        gen.generate_line(tasks[task].dir, tasks[task].line, rack, best[worker],
+                          options.prune ? &ws.bounds[tasks[task].dir * Dim + tasks[task].line] : nullptr);
+    };
+    if (workers > 1) {
+        pool->run(task_count, run_task);
+    } else {
+        for (int t = 0; t < task_count; ++t) run_task(t, 0);
+    }
+
+    for (int w = 1; w < workers; ++w) best[0].merge(best[w]);
+    std::pmr::vector<BasicCandidate<Dim>> out(best[0].items().begin(), best[0].items().end(),
+                                              ws.arena.resource());
+    std::sort(out.begin(), out.end(), candidate_before<Dim>);
+    return out;
+}
+
+} // namespace wrapper
+
+#endif // GEN_MOVEGEN_H
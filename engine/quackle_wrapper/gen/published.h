@@ -0,0 +1,33 @@
+#ifndef GEN_PUBLISHED_H
+#define GEN_PUBLISHED_H
+
+#include <memory>
+#include <utility>
+
+namespace wrapper {
+
+// A value that can be replaced while readers are using it, RCU-style:
+// readers take a snapshot for as long as they need it, a writer publishes
+// the replacement with one atomic store, and the old value is freed by
+// whichever snapshot lets go last. Reference counts stand in for the grace
+// period, so no reader ever waits.
+template <class T>
+class Published {
+public:
+    Published() = default;
+    explicit Published(std::shared_ptr<const T> value) : m_current(std::move(value)) {}
+
+    Published(const Published &) = delete;
+    Published &operator=(const Published &) = delete;
+
+    // Null until something is published
+    std::shared_ptr<const T> acquire() const { return std::atomic_load(&m_current); }
+    void publish(std::shared_ptr<const T> next) { std::atomic_store(&m_current, std::move(next)); }
+
+private:
+    std::shared_ptr<const T> m_current;
+};
+
+} // namespace wrapper
+
+#endif // GEN_PUBLISHED_H
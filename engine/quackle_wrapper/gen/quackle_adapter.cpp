@@ -0,0 +1,54 @@
+#include "gen/quackle_adapter.h"
+
+// Quackle headers (core only, no Qt)
+#include "boardparameters.h"
+#include "datamanager.h"
+#include "evaluator.h"
+#include "gameparameters.h"
+
+namespace wrapper {
+
+template <int Dim>
+BasicRules<Dim> rules_from_quackle() {
+    BasicRules<Dim> rules;
+    auto *alphabet = QUACKLE_DATAMANAGER->alphabetParameters();
+    auto *board = QUACKLE_DATAMANAGER->boardParameters();
+    auto *game = QUACKLE_DATAMANAGER->parameters();
+
+    if (alphabet) {
+        rules.alphabet_size = alphabet->length();
+        if (rules.alphabet_size > kMaxLetters - 1) rules.alphabet_size = kMaxLetters - 1;
+        for (int l = 1; l <= rules.alphabet_size; ++l) rules.tile_score[l] = alphabet->score(to_quackle_letter(l));
+    }
+    if (game) {
+        rules.rack_size = game->rackSize();
+        if (rules.rack_size > kMaxRackTiles) rules.rack_size = kMaxRackTiles;
+        rules.bingo_bonus = game->bingoBonus();
+    }
+    for (int r = 0; r < Dim; ++r) {
+        for (int c = 0; c < Dim; ++c) {
+            const bool on_board = board && r < board->height() && c < board->width();
+            rules.letter_mult[r][c] = static_cast<uint8_t>(on_board ? board->letterMultiplier(r, c) : 1);
+            rules.word_mult[r][c] = static_cast<uint8_t>(on_board ? board->wordMultiplier(r, c) : 1);
+        }
+    }
+    if (board) {
+        rules.center_row = board->startRow();
+        rules.center_col = board->startColumn();
+    }
+    return rules;
+}
+
+template BasicRules<kBoardDim> rules_from_quackle<kBoardDim>();
+template BasicRules<kSuperBoardDim> rules_from_quackle<kSuperBoardDim>();
+
+double quackle_leave_value(const RackCounts &leave) {
+    static const Quackle::ScorePlusLeaveEvaluator evaluator;
+    Quackle::LetterString letters;
+    for (int l = 1; l < kMaxLetters; ++l)
+        for (int k = 0; k < leave.counts[l]; ++k) letters.push_back(to_quackle_letter(static_cast<uint8_t>(l)));
+    for (int k = 0; k < leave.blanks; ++k) letters.push_back(QUACKLE_BLANK_MARK);
+    return evaluator.leaveValue(letters);
+}
+
+} // namespace wrapper
@@ -0,0 +1,54 @@
+#ifndef GEN_QUACKLE_ADAPTER_H
+#define GEN_QUACKLE_ADAPTER_H
+
+#include <cstdint>
+
+// Quackle headers (core only, no Qt)
+#include "alphabetparameters.h"
+#include "gaddag.h"
+
+#include "gen/rack.h"
+#include "gen/rules.h"
+
+namespace wrapper {
+
+inline Quackle::Letter to_quackle_letter(uint8_t letter) {
+    return letter == kSeparator ? static_cast<Quackle::Letter>(QUACKLE_GADDAG_SEPARATOR)
+                                : static_cast<Quackle::Letter>(letter - 1 + QUACKLE_FIRST_LETTER);
+}
+
+inline uint8_t from_quackle_letter(Quackle::Letter letter) {
+    return letter == QUACKLE_GADDAG_SEPARATOR ? kSeparator
+                                              : static_cast<uint8_t>(letter - QUACKLE_FIRST_LETTER + 1);
+}
+
+// Graph view of the GADDAG loaded by Quackle's LexiconParameters
+class QuackleGaddag {
+public:
+    using Node = const Quackle::GaddagNode *;
+
+    explicit QuackleGaddag(Node root) : m_root(root) {}
+
+    Node root() const { return m_root; }
+    Node child(Node node, uint8_t letter) const { return node->child(to_quackle_letter(letter)); }
+    Node first_child(Node node) const { return node->firstChild(); }
+    Node next_sibling(Node node) const { return node->nextSibling(); }
+    uint8_t letter(Node node) const { return from_quackle_letter(node->letter()); }
+    bool terminal(Node node) const { return node->isTerminal(); }
+
+private:
+    Node m_root;
+};
+
+// Scoring rules from the DataManager's game, board and alphabet parameters.
+// Squares beyond Quackle's board keep multiplier 1. Instantiated for
+// kBoardDim and kSuperBoardDim.
+template <int Dim = kBoardDim>
+BasicRules<Dim> rules_from_quackle();
+
+// Leave value as computed by Quackle's score-plus-leave evaluator
+double quackle_leave_value(const RackCounts &leave);
+
+} // namespace wrapper
+
+#endif // GEN_QUACKLE_ADAPTER_H
@@ -0,0 +1,40 @@
+#ifndef GEN_RACK_H
+#define GEN_RACK_H
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+#include "gen/rules.h"
+
+namespace wrapper {
+
+// Multiset view of a rack: per-letter counts plus undesignated blanks
+struct RackCounts {
+    uint8_t counts[kMaxLetters] = {};
+    uint8_t blanks = 0;
+    int size = 0;
+
+    bool empty() const { return size == 0; }
+
+    void add(uint8_t letter) { ++counts[letter]; ++size; }
+    void add_blank() { ++blanks; ++size; }
+
+    bool operator==(const RackCounts &o) const {
+        return blanks == o.blanks && size == o.size && std::memcmp(counts, o.counts, sizeof(counts)) == 0;
+    }
+};
+
+// Builds counts from a normalized rack string (A-Z and '?')
+inline RackCounts rack_from_string(const std::string &rack) {
+    RackCounts out;
+    for (char c : rack) {
+        if (c == '?') out.add_blank();
+        else if (c >= 'A' && c <= 'Z') out.add(static_cast<uint8_t>(c - 'A' + 1));
+    }
+    return out;
+}
+
+} // namespace wrapper
+
+#endif // GEN_RACK_H
@@ -0,0 +1,165 @@
+#include "gen/residency.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <vector>
+
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace wrapper {
+
+namespace {
+
+constexpr size_t kHugePage = size_t(2) << 20;
+constexpr int kMpolPreferred = 1;  // <numaif.h>, without linking libnuma
+constexpr int kMaxNumaNode = 1023;
+
+size_t round_up(size_t bytes, size_t unit) { return (bytes + unit - 1) / unit * unit; }
+
+std::string errno_text(const char *what) { return std::string(what) + ": " + std::strerror(errno); }
+
+// Anonymous read-write region of `length` bytes starting on a huge page
+// boundary, so transparent huge pages can back all of it
+void *map_aligned(size_t length) {
+    const size_t padded = length + kHugePage;
+    void *raw = ::mmap(nullptr, padded, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (raw == MAP_FAILED) return MAP_FAILED;
+    const uintptr_t start = reinterpret_cast<uintptr_t>(raw);
+    const uintptr_t aligned = round_up(start, kHugePage);
+    if (aligned > start) ::munmap(raw, aligned - start);
+    const uintptr_t end = aligned + length;
+    if (start + padded > end) ::munmap(reinterpret_cast<void *>(end), start + padded - end);
+    return reinterpret_cast<void *>(aligned);
+}
+
+bool prefer_node(void *region, size_t length, int node) {
+    unsigned long mask[(kMaxNumaNode + 1) / (8 * sizeof(unsigned long))] = {};
+    mask[node / (8 * sizeof(unsigned long))] |= 1ul << (node % (8 * sizeof(unsigned long)));
+    return ::syscall(SYS_mbind, region, length, kMpolPreferred, mask, kMaxNumaNode + 1, 0) == 0;
+}
+
+} // namespace
+
+void make_resident(void *&map, size_t bytes, const ResidencyOptions &options, Residency &out) {
+    out = Residency();
+    if (options.copies()) {
+        size_t length = options.huge_pages ? round_up(bytes, kHugePage) : bytes;
+        void *copy = MAP_FAILED;
+        if (options.huge_pages) {
+            copy = ::mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+            out.hugetlb = copy != MAP_FAILED;
+            if (copy == MAP_FAILED) {
+                copy = map_aligned(length);
+                out.thp = copy != MAP_FAILED && ::madvise(copy, length, MADV_HUGEPAGE) == 0;
+                if (copy != MAP_FAILED && !out.thp) out.error = errno_text("madvise(MADV_HUGEPAGE)");
+            }
+        } else {
+            copy = ::mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        }
+        if (copy == MAP_FAILED) {
+            out.hugetlb = false;
+            out.error = errno_text("mmap copy");
+        } else {
+            // Placed before the first touch, so the copy's pages land on the node
+            if (options.numa_node >= 0) {
+                if (options.numa_node <= kMaxNumaNode && prefer_node(copy, length, options.numa_node))
+                    out.numa_node = options.numa_node;
+                else if (out.error.empty())
+                    out.error = errno_text("mbind");
+            }
+            std::memcpy(copy, map, bytes);
+            ::mprotect(copy, length, PROT_READ);
+            ::munmap(map, bytes);
+            map = copy;
+            out.copied = true;
+            out.map_bytes = length;
+        }
+    }
+    if (options.lock) {
+        out.locked = ::mlock(map, out.copied ? out.map_bytes : bytes) == 0;
+        if (!out.locked && out.error.empty()) out.error = errno_text("mlock");
+    }
+    if (!out.error.empty()) std::fprintf(stderr, "[residency] %s\n", out.error.c_str());
+}
+
+void release_resident(void *map, size_t bytes, const Residency &residency) {
+    if (map) ::munmap(map, residency.map_bytes ? residency.map_bytes : bytes);
+}
+
+size_t resident_bytes(const void *map, size_t bytes) {
+    if (!map || !bytes) return 0;
+    const size_t page = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+    const uintptr_t start = reinterpret_cast<uintptr_t>(map) / page * page;
+    const size_t length = reinterpret_cast<uintptr_t>(map) + bytes - start;
+    std::vector<unsigned char> pages(round_up(length, page) / page);
+    if (::mincore(reinterpret_cast<void *>(start), length, pages.data()) != 0) return 0;
+    const size_t in_core = std::count_if(pages.begin(), pages.end(), [](unsigned char p) { return p & 1; });
+    return std::min(in_core * page, bytes);
+}
+
+size_t huge_page_bytes(const void *map, size_t bytes, const Residency &residency) {
+    if (!map) return 0;
+    if (residency.hugetlb) return bytes;
+    // The table's own mapping in smaps: anonymous (copy) or file-backed huge
+    // pages, clamped to the table in case the kernel merged it with a neighbour
+    const uintptr_t at = reinterpret_cast<uintptr_t>(map);
+    std::ifstream smaps("/proc/self/smaps");
+    std::string line;
+    bool inside = false;
+    size_t huge = 0, vma_bytes = 0;
+    while (std::getline(smaps, line)) {
+        unsigned long lo = 0, hi = 0;
+        if (std::sscanf(line.c_str(), "%lx-%lx ", &lo, &hi) == 2) {
+            if (inside) break;
+            inside = at >= lo && at < hi;
+            vma_bytes = hi - lo;
+            continue;
+        }
+        if (!inside) continue;
+        std::istringstream fields(line);
+        std::string key;
+        size_t kb = 0;
+        if (fields >> key >> kb && (key == "AnonHugePages:" || key == "FilePmdMapped:")) huge += kb << 10;
+    }
+    return std::min({huge, vma_bytes, bytes});
+}
+
+bool pin_to_numa_node(int node, std::string &error) {
+    std::ifstream in("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist");
+    std::string list;
+    if (!(in >> list)) {
+        error = "no NUMA node " + std::to_string(node);
+        return false;
+    }
+    // "0-15,32-47"
+    cpu_set_t cpus;
+    CPU_ZERO(&cpus);
+    std::istringstream ranges(list);
+    std::string range;
+    while (std::getline(ranges, range, ',')) {
+        int lo = 0, hi = 0;
+        const int got = std::sscanf(range.c_str(), "%d-%d", &lo, &hi);
+        if (got < 1) continue;
+        if (got == 1) hi = lo;
+        for (int cpu = lo; cpu <= hi && cpu < CPU_SETSIZE; ++cpu) CPU_SET(cpu, &cpus);
+    }
+    if (!CPU_COUNT(&cpus)) {
+        error = "NUMA node " + std::to_string(node) + " has no CPUs";
+        return false;
+    }
+    if (::sched_setaffinity(0, sizeof(cpus), &cpus) != 0) {
+        error = errno_text("sched_setaffinity");
+        return false;
+    }
+    return true;
+}
+
+} // namespace wrapper
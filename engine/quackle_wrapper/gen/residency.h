@@ -0,0 +1,54 @@
+#ifndef GEN_RESIDENCY_H
+#define GEN_RESIDENCY_H
+
+#include <cstddef>
+#include <string>
+
+namespace wrapper {
+
+// Where the mapped lexicon and leave tables live once opened. By default
+// they stay file mappings in the shared page cache. Huge pages or a NUMA
+// node give each table a private anonymous copy instead: backed by reserved
+// hugetlbfs pages when there are enough, else by transparent huge pages,
+// and placed on the node when one is given. Locking pins whichever memory
+// the table ends up in, so no lookup takes a major fault after an idle spell.
+struct ResidencyOptions {
+    bool huge_pages = false;
+    bool lock = false;
+    int numa_node = -1;  // -1 = wherever the kernel puts it
+
+    bool copies() const { return huge_pages || numa_node >= 0; }
+    bool any() const { return copies() || lock; }
+};
+
+// What was done to one table
+struct Residency {
+    bool copied = false;    // private copy in place of the file mapping
+    bool hugetlb = false;   // copy on reserved huge pages
+    bool thp = false;       // copy advised to transparent huge pages
+    bool locked = false;
+    int numa_node = -1;     // node the copy prefers
+    size_t map_bytes = 0;   // length of the region to unmap; 0 = the table size
+    std::string error;      // first step that did not take; the table still works
+};
+
+// Applies `options` to the table of `bytes` mapped at `map`. On a copy, the
+// file mapping is unmapped and `map` moves to the copy; a step that fails
+// is logged in `out.error` and the rest still apply.
+void make_resident(void *&map, size_t bytes, const ResidencyOptions &options, Residency &out);
+
+// Unmaps a table mapped at `map`, file mapping or copy alike
+void release_resident(void *map, size_t bytes, const Residency &residency);
+
+// Bytes of the table currently in memory, and how many of those are on
+// huge pages (from /proc/self/smaps)
+size_t resident_bytes(const void *map, size_t bytes);
+size_t huge_page_bytes(const void *map, size_t bytes, const Residency &residency);
+
+// Restricts the calling thread, and every thread it starts afterwards, to
+// the CPUs of NUMA node `node`
+bool pin_to_numa_node(int node, std::string &error);
+
+} // namespace wrapper
+
+#endif // GEN_RESIDENCY_H
@@ -0,0 +1,64 @@
+#ifndef GEN_RULES_H
+#define GEN_RULES_H
+
+#include <cstdint>
+
+namespace wrapper {
+
+// Letters inside the generator are small integers 1..alphabet_size.
+// 0 means "empty square" on the board and "separator" on GADDAG arcs.
+// Board types are templated on the side length so every per-line loop has a
+// compile-time bound; kBoardDim is the standard board, kSuperBoardDim the
+// 21x21 Super board.
+constexpr int kBoardDim = 15;
+constexpr int kSuperBoardDim = 21;
+constexpr int kMaxLetters = 32;
+// Longest rack the generator serves: leave tables, leave files, exchanges
+// and move keys are all sized for it
+constexpr int kMaxRackTiles = 7;
+constexpr uint8_t kSeparator = 0;
+
+// Tile encoding used for board squares and candidate words
+constexpr uint8_t kLetterMask = 0x3f;
+constexpr uint8_t kBlankBit = 0x40;    // tile is a designated blank (scores 0)
+constexpr uint8_t kThroughBit = 0x80;  // tile was already on the board
+
+inline uint8_t tile_letter(uint8_t tile) { return tile & kLetterMask; }
+inline bool tile_is_blank(uint8_t tile) { return (tile & kBlankBit) != 0; }
+inline bool tile_is_through(uint8_t tile) { return (tile & kThroughBit) != 0; }
+
+// Scoring rules and board geometry, filled once at startup from Quackle's
+// game/board/alphabet parameters (see quackle_adapter.h).
+template <int Dim>
+struct BasicRules {
+    static constexpr int kDim = Dim;
+
+    int alphabet_size = 26;
+    int rack_size = 7;
+    int bingo_bonus = 50;
+    int center_row = Dim / 2;
+    int center_col = Dim / 2;
+    int tile_score[kMaxLetters] = {};
+    uint8_t letter_mult[Dim][Dim] = {};
+    uint8_t word_mult[Dim][Dim] = {};
+
+    uint32_t all_letters() const {
+        return ((alphabet_size + 1 >= 32) ? 0xffffffffu : ((1u << (alphabet_size + 1)) - 1)) & ~1u;
+    }
+
+    // Swapping rows and columns leaves the centre and every premium square
+    // in place, so each vertical play mirrors a horizontal one
+    bool symmetric_about_diagonal() const {
+        if (center_row != center_col) return false;
+        for (int r = 0; r < Dim; ++r)
+            for (int c = r + 1; c < Dim; ++c)
+                if (letter_mult[r][c] != letter_mult[c][r] || word_mult[r][c] != word_mult[c][r]) return false;
+        return true;
+    }
+};
+
+using Rules = BasicRules<kBoardDim>;
+
+} // namespace wrapper
+
+#endif // GEN_RULES_H
@@ -0,0 +1,175 @@
+#include "gen/ruleset.h"
+
+#include <algorithm>
+#include <cctype>
+#include <fstream>
+#include <sstream>
+#include <vector>
+
+namespace wrapper {
+
+namespace {
+
+// Quackle alphabet lines: "A a 1 9 1" (text, blank text, score, count,
+// vowel) and "blank 0 2" (score, count); '#' starts a comment
+bool load_alphabet(const std::string &path, RulesetContext &out, std::string &error) {
+    std::ifstream in(path);
+    if (!in) {
+        error = "cannot open alphabet " + path;
+        return false;
+    }
+    for (int l = 0; l < kMaxLetters; ++l) out.rules.tile_score[l] = 0;
+    out.letters = 0;
+    out.blanks = 0;
+    std::string line;
+    for (int n = 1; std::getline(in, line); ++n) {
+        if (line.empty() || line[0] == '#') continue;
+        std::istringstream fields(line);
+        std::string text;
+        fields >> text;
+        if (text.empty()) continue;
+        if (text == "blank") {
+            int score = 0;
+            if (!(fields >> score >> out.blanks)) {
+                error = path + ":" + std::to_string(n) + ": bad blank line";
+                return false;
+            }
+            continue;
+        }
+        std::string blank_text;
+        int score = 0, count = 0;
+        if (text.size() != 1 || text[0] < 'A' || text[0] > 'Z' || !(fields >> blank_text >> score >> count)) {
+            error = path + ":" + std::to_string(n) + ": expected a letter A-Z with its score and count";
+            return false;
+        }
+        const int letter = text[0] - 'A' + 1;
+        out.rules.tile_score[letter] = score;
+        out.letters |= 1u << letter;
+    }
+    if (!out.letters) {
+        error = "alphabet " + path + " has no letters";
+        return false;
+    }
+    return true;
+}
+
+bool load_board(const std::string &path, Rules &rules, std::string &error) {
+    std::ifstream in(path);
+    if (!in) {
+        error = "cannot open board " + path;
+        return false;
+    }
+    std::vector<std::string> rows;
+    std::string line;
+    while (std::getline(in, line)) {
+        while (!line.empty() && std::isspace(static_cast<unsigned char>(line.back()))) line.pop_back();
+        if (!line.empty() && line[0] != '#') rows.push_back(line);
+    }
+    if (rows.size() != kBoardDim) {
+        error = "board " + path + " needs " + std::to_string(kBoardDim) + " rows";
+        return false;
+    }
+    int starts = 0;
+    for (int r = 0; r < kBoardDim; ++r) {
+        if (rows[r].size() != kBoardDim) {
+            error = "board " + path + " row " + std::to_string(r + 1) + " is not " + std::to_string(kBoardDim) +
+                    " squares";
+            return false;
+        }
+        for (int c = 0; c < kBoardDim; ++c) {
+            uint8_t letter = 1, word = 1;
+            switch (rows[r][c]) {
+            case '.': break;
+            case 'd': letter = 2; break;
+            case 't': letter = 3; break;
+            case 'D': word = 2; break;
+            case 'T': word = 3; break;
+            case '*':
+                word = 2;
+                rules.center_row = r;
+                rules.center_col = c;
+                ++starts;
+                break;
+            default:
+                error = "board " + path + ": unknown square '" + std::string(1, rows[r][c]) + "'";
+                return false;
+            }
+            rules.letter_mult[r][c] = letter;
+            rules.word_mult[r][c] = word;
+        }
+    }
+    if (starts != 1) {
+        error = "board " + path + " needs exactly one start square '*'";
+        return false;
+    }
+    return true;
+}
+
+bool parse_int(const std::string &text, int lo, int hi, int &out) {
+    if (text.empty() || text.size() > 4) return false;
+    for (char c : text)
+        if (!std::isdigit(static_cast<unsigned char>(c))) return false;
+    out = std::stoi(text);
+    return out >= lo && out <= hi;
+}
+
+} // namespace
+
+bool load_ruleset(const std::string &spec, const Rules &base, const ResidencyOptions &residency, RulesetContext &out,
+                  std::string &error) {
+    const size_t colon = spec.find(':');
+    if (colon == std::string::npos || colon == 0) {
+        error = "expected name:key=value,...";
+        return false;
+    }
+    out.name = spec.substr(0, colon);
+    if (out.name.size() > 16 ||
+        !std::all_of(out.name.begin(), out.name.end(), [](unsigned char c) { return std::isalnum(c) != 0; })) {
+        error = "ruleset names are up to 16 letters and digits";
+        return false;
+    }
+    out.rules = base;
+
+    std::string alphabet, lexicon, board, leaves;
+    std::istringstream items(spec.substr(colon + 1));
+    std::string item;
+    while (std::getline(items, item, ',')) {
+        const size_t eq = item.find('=');
+        const std::string key = item.substr(0, eq);
+        const std::string value = eq == std::string::npos ? std::string() : item.substr(eq + 1);
+        bool ok = !value.empty();
+        if (key == "alphabet") alphabet = value;
+        else if (key == "lexicon") lexicon = value;
+        else if (key == "board") board = value;
+        else if (key == "leaves") leaves = value;
+        else if (key == "rack") ok = ok && parse_int(value, 1, kMaxRackTiles, out.rules.rack_size);
+        else if (key == "bingo") ok = ok && parse_int(value, 0, 1000, out.rules.bingo_bonus);
+        else ok = false;
+        if (!ok) {
+            error = "bad item '" + item + "'";
+            return false;
+        }
+    }
+    if (alphabet.empty() || lexicon.empty()) {
+        error = "alphabet and lexicon are required";
+        return false;
+    }
+    if (!load_alphabet(alphabet, out, error)) return false;
+    if (!board.empty() && !load_board(board, out.rules, error)) return false;
+    std::string map_error;
+    auto graph = std::make_shared<MappedGraph>();
+    if (!graph->open(lexicon, map_error)) {
+        error = "lexicon " + lexicon + ": " + map_error;
+        return false;
+    }
+    graph->apply_residency(residency);
+    out.graph = std::move(graph);
+    if (!leaves.empty() && !out.leaves.open(leaves, map_error)) {
+        error = "leaves " + leaves + ": " + map_error;
+        return false;
+    }
+    out.leaves.apply_residency(residency);
+    return true;
+}
+
+} // namespace wrapper
@@ -0,0 +1,51 @@
+#ifndef GEN_RULESET_H
+#define GEN_RULESET_H
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "gen/leave_file.h"
+#include "gen/mapped_graph.h"
+#include "gen/rack.h"
+#include "gen/residency.h"
+#include "gen/rules.h"
+
+namespace wrapper {
+
+// A ruleset served beside the one Quackle is set up for: tile values, rack
+// size, bingo bonus, board premiums, lexicon and leave table, all loaded at
+// startup and selected per request by name. Letters keep the A..Z numbering
+// the rest of the generator uses; `letters` marks the ones the alphabet has.
+struct RulesetContext {
+    std::string name;
+    Rules rules;
+    uint32_t letters = 0;  // bit l: letter l is in the alphabet
+    int blanks = 0;        // blanks in the bag
+    std::shared_ptr<const MappedGraph> graph;
+    MappedLeaves leaves;   // optional; without it equity is the score alone
+
+    bool has_letter(uint8_t letter) const { return (letters >> letter) & 1u; }
+    bool has_letters(const RackCounts &tiles) const {
+        for (int l = 1; l < kMaxLetters; ++l)
+            if (tiles.counts[l] && !has_letter(static_cast<uint8_t>(l))) return false;
+        return tiles.blanks <= blanks;
+    }
+};
+
+// Loads a context from "name:key=value,key=value...", the name being up to
+// 16 letters and digits. Keys:
+//   alphabet  Quackle .quackle_alphabet file (letters A-Z only)     required
+//   lexicon   mapped GADDAG from tools/mapgaddag                    required
+//   board     15 lines of 15 squares: . d t D T, * = start (2x word)
+//   leaves    leave table from tools/makeleaves
+//   rack      rack size
+//   bingo     bonus for playing the whole rack
+// Anything not given keeps its value from `base`; the lexicon and leave
+// table get `residency` applied. On failure `error` says which part is wrong.
+bool load_ruleset(const std::string &spec, const Rules &base, const ResidencyOptions &residency, RulesetContext &out,
+                  std::string &error);
+
+} // namespace wrapper
+
+#endif // GEN_RULESET_H
@@ -0,0 +1,129 @@
+#ifndef GEN_SCORE_BOUND_H
+#define GEN_SCORE_BOUND_H
+
+#include <algorithm>
+
+#include "gen/board_state.h"
+#include "gen/rack.h"
+#include "gen/rules.h"
+
+namespace wrapper {
+
+// Partial score of the word being built: letter sum of the main word, its
+// word multiplier so far and the finished cross words.
+struct PartialScore {
+    int main = 0;
+    int word_mult = 1;
+    int cross = 0;
+};
+
+// Optimistic bound on the score any extension of a partial play on one line
+// can still reach, given how many rack tiles are left. Remaining tiles are
+// paired, best with best, against the best letter/word multipliers and
+// cross-word values of the squares still reachable (rearrangement
+// inequality), and every tile already on those squares is counted as part of
+// the word. Never below the real score, so pruning against it keeps the
+// top-N exact.
+//
+// Tables are kept per suffix of the line: squares [from, Dim). The right
+// extension past `pos` can only reach pos + 1 onwards; the left part can
+// still reach both sides of the anchor and uses the whole line.
+template <int Dim>
+class BasicLineBound {
+public:
+    void build(const BasicBoardState<Dim> &board, const BasicRules<Dim> &rules, const RackCounts &rack, int dir,
+               int line) {
+        // Only the best Dim tiles can ever be placed on one line
+        SortedInts faces;
+        for (int l = 1; l < kMaxLetters; ++l)
+            for (int k = 0; k < rack.counts[l]; ++k) faces.insert(rules.tile_score[l]);
+        for (int k = 0; k < rack.blanks; ++k) faces.insert(0);
+        m_rack_size = rules.rack_size;
+        m_bingo_bonus = rules.bingo_bonus;
+
+        SortedInts lm, wm, cross_fixed, cross_mult;
+        int through = 0;
+        for (int from = Dim - 1; from >= 0; --from) {
+            const Square &sq = board.at(dir, line, from);
+            if (sq.tile) {
+                if (!tile_is_blank(sq.tile)) through += rules.tile_score[tile_letter(sq.tile)];
+            } else {
+                const int row = BasicBoardState<Dim>::row_of(dir, line, from);
+                const int col = BasicBoardState<Dim>::col_of(dir, line, from);
+                const int l = rules.letter_mult[row][col];
+                const int w = rules.word_mult[row][col];
+                lm.insert(l);
+                wm.insert(w);
+                if (sq.has_cross) {
+                    cross_fixed.insert(sq.cross_score * w);
+                    cross_mult.insert(l * w);
+                }
+            }
+
+            Table &t = m_tables[from];
+            t.through = through;
+            t.empties = lm.size;
+            const int n = std::min(faces.size, t.empties);
+            for (int i = 0; i < n; ++i) {
+                const int f = faces.v[i];
+                t.letters[i + 1] = t.letters[i] + f * lm.v[i];
+                t.word_mult[i + 1] = t.word_mult[i] * wm.v[i];
+                t.cross[i + 1] = t.cross[i];
+                if (i < cross_fixed.size) t.cross[i + 1] += cross_fixed.v[i] + f * cross_mult.v[i];
+            }
+            for (int i = n + 1; i <= Dim; ++i) {
+                t.letters[i] = t.letters[n];
+                t.word_mult[i] = t.word_mult[n];
+                t.cross[i] = t.cross[n];
+            }
+        }
+    }
+
+    // Bound for a partial play that can still place up to `remaining` tiles
+    // on squares [from, Dim)
+    int score(const PartialScore &partial, int placed, int remaining, int from) const {
+        if (from >= Dim) return partial.main * partial.word_mult + partial.cross +
+                                      (placed >= m_rack_size ? m_bingo_bonus : 0);
+        const Table &t = m_tables[from];
+        const int r = std::min(remaining, t.empties);
+        return (partial.main + t.through + t.letters[r]) * partial.word_mult * t.word_mult[r] +
+               partial.cross + t.cross[r] + (placed + r >= m_rack_size ? m_bingo_bonus : 0);
+    }
+
+private:
+    struct Table {
+        int through = 0;             // board tiles on the suffix
+        int empties = 0;             // empty squares on the suffix
+        int letters[Dim + 1] = {};   // best letter sum for i more tiles
+        int word_mult[Dim + 1];      // best word multiplier for i more tiles
+        int cross[Dim + 1] = {};     // best cross-word total for i more tiles
+
+        Table() {
+            for (int &w : word_mult) w = 1;
+        }
+    };
+
+    // Up to Dim values, largest first; smaller values drop off the end
+    struct SortedInts {
+        int v[Dim] = {};
+        int size = 0;
+
+        void insert(int x) {
+            int i = Dim - 1;
+            if (size < Dim) i = size++;
+            else if (x <= v[i]) return;
+            for (; i > 0 && v[i - 1] < x; --i) v[i] = v[i - 1];
+            v[i] = x;
+        }
+    };
+
+    int m_rack_size = 7;
+    int m_bingo_bonus = 50;
+    Table m_tables[Dim];
+};
+
+using LineBound = BasicLineBound<kBoardDim>;
+
+} // namespace wrapper
+
+#endif // GEN_SCORE_BOUND_H
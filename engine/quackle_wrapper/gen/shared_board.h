@@ -0,0 +1,49 @@
+#ifndef GEN_SHARED_BOARD_H
+#define GEN_SHARED_BOARD_H
+
+#include <memory>
+#include <utility>
+
+#include "gen/board_state.h"
+
+namespace wrapper {
+
+// Copy-on-write handle to a BoardState. Copying the handle shares the board
+// (a snapshot costs one reference count); mutate() clones only while someone
+// else still holds a snapshot. A long-lived handle that is refilled every
+// request therefore reuses one board unless a snapshot was kept.
+//
+// Readers and snapshots may live on any thread; mutate() is for the thread
+// that owns the handle.
+template <int Dim>
+class BasicSharedBoard {
+public:
+    using BoardState = BasicBoardState<Dim>;
+
+    BasicSharedBoard() : m_state(std::make_shared<BoardState>()) {}
+    explicit BasicSharedBoard(BoardState &&state) : m_state(std::make_shared<BoardState>(std::move(state))) {}
+
+    const BoardState &get() const { return *m_state; }
+    const BoardState &operator*() const { return *m_state; }
+    const BoardState *operator->() const { return m_state.get(); }
+
+    BoardState &mutate() {
+        if (m_state.use_count() > 1) m_state = std::make_shared<BoardState>(*m_state);
+        return *m_state;
+    }
+
+    // Shares the current board; later mutate() calls on this handle do not
+    // affect the snapshot
+    BasicSharedBoard snapshot() const { return *this; }
+
+    bool shared() const { return m_state.use_count() > 1; }
+
+private:
+    std::shared_ptr<BoardState> m_state;
+};
+
+using SharedBoard = BasicSharedBoard<kBoardDim>;
+
+} // namespace wrapper
+
+#endif // GEN_SHARED_BOARD_H
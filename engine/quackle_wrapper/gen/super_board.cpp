@@ -0,0 +1,23 @@
+// The 21x21 Super board generator, instantiated here so it is compiled (and
+// kept compiling) alongside the standard board used by the engine.
+
+#include "gen/movegen.h"
+#include "gen/quackle_adapter.h"
+#include "gen/shared_board.h"
+
+namespace wrapper {
+
+template class BasicBoardState<kSuperBoardDim>;
+template void BasicBoardState<kSuperBoardDim>::prepare<QuackleGaddag>(const QuackleGaddag &,
+                                                                      const BasicRules<kSuperBoardDim> &);
+template class BasicSharedBoard<kSuperBoardDim>;
+template class BasicLineBound<kSuperBoardDim>;
+template class BasicTopK<kSuperBoardDim>;
+template class MoveGenerator<QuackleGaddag, kSuperBoardDim>;
+template std::pmr::vector<BasicCandidate<kSuperBoardDim>>
+generate_moves<QuackleGaddag, kSuperBoardDim>(const QuackleGaddag &, const BasicBoardState<kSuperBoardDim> &,
+                                              const BasicRules<kSuperBoardDim> &, const RackCounts &,
+                                              const LeaveTable &, WorkPool *, const GenOptions &,
+                                              BasicGenWorkspace<kSuperBoardDim> &);
+
+} // namespace wrapper
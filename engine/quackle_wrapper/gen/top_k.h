@@ -0,0 +1,76 @@
+#ifndef GEN_TOP_K_H
+#define GEN_TOP_K_H
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+#include "gen/candidate.h"
+#include "gen/move_keys.h"
+
+namespace wrapper {
+
+// Keeps the best `limit` candidates seen so far in a min-heap whose top is
+// the worst kept candidate, so a new candidate costs one comparison unless it
+// makes the cut. A limit of 0 keeps everything (the "all plays" case).
+// Candidates that make the cut are checked against a key set first, so a
+// duplicate placement is dropped on insertion and never holds a slot.
+template <int Dim>
+class BasicTopK {
+public:
+    using Candidate = BasicCandidate<Dim>;
+
+    explicit BasicTopK(size_t limit = 0) { reset(limit); }
+
+    // Empties the heap and key set for a new request; keeps their memory
+    void reset(size_t limit) {
+        m_limit = limit;
+        m_heap.clear();
+        m_keys.clear();
+        if (m_limit) m_heap.reserve(m_limit);
+    }
+
+    size_t limit() const { return m_limit; }
+    size_t size() const { return m_heap.size(); }
+    bool full() const { return m_limit && m_heap.size() >= m_limit; }
+
+    // Worst kept candidate; only meaningful when full()
+    const Candidate &worst() const { return m_heap.front(); }
+
+    void push(const Candidate &c) {
+        // A duplicate arriving after its twin was evicted ranks the same and
+        // fails this test too, so keys never need removing
+        if (full() && !candidate_before(c, m_heap.front())) return;
+        if (!m_keys.insert(candidate_key(c))) return;
+        if (!m_limit) {
+            m_heap.push_back(c);
+            return;
+        }
+        if (m_heap.size() < m_limit) {
+            m_heap.push_back(c);
+            std::push_heap(m_heap.begin(), m_heap.end(), candidate_before<Dim>);
+            return;
+        }
+        std::pop_heap(m_heap.begin(), m_heap.end(), candidate_before<Dim>);
+        m_heap.back() = c;
+        std::push_heap(m_heap.begin(), m_heap.end(), candidate_before<Dim>);
+    }
+
+    void merge(const BasicTopK &other) {
+        for (const Candidate &c : other.m_heap) push(c);
+    }
+
+    // Kept candidates in heap order
+    const std::vector<Candidate> &items() const { return m_heap; }
+
+private:
+    size_t m_limit = 0;
+    std::vector<Candidate> m_heap;
+    MoveKeySet m_keys;
+};
+
+using TopK = BasicTopK<kBoardDim>;
+
+} // namespace wrapper
+
+#endif // GEN_TOP_K_H
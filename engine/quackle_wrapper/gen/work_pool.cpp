@@ -0,0 +1,98 @@
+#include "gen/work_pool.h"
+
+namespace wrapper {
+
+WorkPool::WorkPool(int workers) {
+    if (workers < 1) workers = 1;
+    for (int i = 0; i < workers; ++i) m_queues.push_back(std::make_unique<Queue>());
+    for (int i = 1; i < workers; ++i) m_threads.emplace_back(&WorkPool::worker_loop, this, i);
+}
+
+WorkPool::~WorkPool() {
+    {
+        std::lock_guard<std::mutex> lock(m_mu);
+        m_stop = true;
+    }
+    m_wake.notify_all();
+    for (auto &t : m_threads) t.join();
+}
+
+void WorkPool::run_erased(int tasks, Task task) {
+    if (tasks <= 0) return;
+    {
+        std::lock_guard<std::mutex> lock(m_mu);
+        m_task = task;
+        m_error = nullptr;
+        m_remaining.store(tasks);
+        const int n = size();
+        for (int w = 0; w < n; ++w) {
+            Queue &q = *m_queues[w];
+            std::lock_guard<std::mutex> qlock(q.mu);
+            q.tasks.clear();
+            for (int t = w; t < tasks; t += n) q.tasks.push_back(t);
+            q.head = 0;
+            q.tail = q.tasks.size();
+        }
+        ++m_generation;
+    }
+    m_wake.notify_all();
+
+    drain(0);
+
+    std::unique_lock<std::mutex> lock(m_mu);
+    m_done.wait(lock, [this] { return m_remaining.load() == 0; });
+    m_task = Task();
+    if (m_error) std::rethrow_exception(m_error);
+}
+
+bool WorkPool::next_task(int worker, int &task) {
+    {
+        Queue &own = *m_queues[worker];
+        std::lock_guard<std::mutex> lock(own.mu);
+        if (own.head < own.tail) {
+            task = own.tasks[own.head++];
+            return true;
+        }
+    }
+    const int n = size();
+    for (int i = 1; i < n; ++i) {
+        Queue &victim = *m_queues[(worker + i) % n];
+        std::lock_guard<std::mutex> lock(victim.mu);
+        if (victim.head < victim.tail) {
+            task = victim.tasks[--victim.tail];
+            return true;
+        }
+    }
+    return false;
+}
+
+void WorkPool::drain(int worker) {
+    int task = 0;
+    while (next_task(worker, task)) {
+        try {
+            m_task.call(m_task.ctx, task, worker);
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(m_mu);
+            if (!m_error) m_error = std::current_exception();
+        }
+        if (m_remaining.fetch_sub(1) == 1) {
+            std::lock_guard<std::mutex> lock(m_mu);
+            m_done.notify_all();
+        }
+    }
+}
+
+void WorkPool::worker_loop(int worker) {
+    uint64_t seen = 0;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(m_mu);
+            m_wake.wait(lock, [&] { return m_stop || m_generation != seen; });
+            if (m_stop) return;
+            seen = m_generation;
+        }
+        drain(worker);
+    }
+}
+
+} // namespace wrapper
@@ -0,0 +1,73 @@
+#ifndef GEN_WORK_POOL_H
+#define GEN_WORK_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace wrapper {
+
+// Small work-stealing pool for intra-request parallelism. Tasks of one run()
+// are dealt round-robin into per-worker queues; a worker pops from the front
+// of its own queue and steals from the back of the others when it runs dry.
+// The calling thread takes part as worker 0. Once the queues have grown to
+// the largest run, run() does not allocate.
+class WorkPool {
+public:
+    explicit WorkPool(int workers);
+    ~WorkPool();
+
+    WorkPool(const WorkPool &) = delete;
+    WorkPool &operator=(const WorkPool &) = delete;
+
+    int size() const { return static_cast<int>(m_queues.size()); }
+
+    // Runs fn(task, worker) for every task in [0, tasks) and returns when
+    // all are done. The first exception thrown by a task is rethrown here.
+    template <class Fn>
+    void run(int tasks, Fn &fn) {
+        run_erased(tasks, Task{&fn, [](void *ctx, int task, int worker) { (*static_cast<Fn *>(ctx))(task, worker); }});
+    }
+
+private:
+    // Non-owning, allocation-free reference to the caller's callable
+    struct Task {
+        void *ctx = nullptr;
+        void (*call)(void *ctx, int task, int worker) = nullptr;
+    };
+
+    // Tasks in [head, tail) of a buffer refilled each run
+    struct Queue {
+        std::mutex mu;
+        std::vector<int> tasks;
+        size_t head = 0;
+        size_t tail = 0;
+    };
+
+    void run_erased(int tasks, Task task);
+    bool next_task(int worker, int &task);
+    void drain(int worker);
+    void worker_loop(int worker);
+
+    std::vector<std::unique_ptr<Queue>> m_queues;
+    std::vector<std::thread> m_threads;
+
+    std::mutex m_mu;
+    std::condition_variable m_wake;
+    std::condition_variable m_done;
+    uint64_t m_generation = 0;
+    bool m_stop = false;
+
+    Task m_task;
+    std::atomic<int> m_remaining{0};
+    std::exception_ptr m_error;
+};
+
+} // namespace wrapper
+
+#endif // GEN_WORK_POOL_H
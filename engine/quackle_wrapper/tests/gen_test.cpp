@@ -0,0 +1,1022 @@
+// Checks the wrapper move generator against a brute-force enumerator. No
+// Quackle: the GADDAG is built here from a small word list, and rules and
+// leave values are set up by hand.
+//
+//   gen_test [scratch dir]
+//
+// Exits non-zero if any check fails.
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <map>
+#include <memory>
+#include <random>
+#include <set>
+#include <string>
+#include <thread>
+#include <unordered_set>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <vector>
+
+#include "gen/board_state.h"
+#include "gen/constraints.h"
+#include "gen/exchange.h"
+#include "gen/gaddag_builder.h"
+#include "gen/leave_file.h"
+#include "gen/lexicon_registry.h"
+#include "gen/mapped_graph.h"
+#include "gen/move_store.h"
+#include "gen/movegen.h"
+#include "gen/published.h"
+#include "gen/ruleset.h"
+#include "gen/work_pool.h"
+
+using namespace wrapper;
+
+namespace {
+
+const char *const kWords[] = {
+    "AA", "AB", "AD", "AE", "AG", "AH", "AI", "AL", "AM", "AN", "AR", "AS", "AT", "AW", "AX", "AY",
+    "BA", "BE", "BI", "BO", "BY", "DE", "DO", "ED", "EF", "EH", "EL", "EM", "EN", "ER", "ES", "ET",
+    "EX", "FA", "GO", "HA", "HE", "HI", "HO", "ID", "IF", "IN", "IS", "IT", "JO", "KA", "LA", "LI",
+    "LO", "MA", "ME", "MI", "MO", "MU", "MY", "NA", "NE", "NO", "NU", "OD", "OE", "OF", "OH", "OI",
+    "OM", "ON", "OP", "OR", "OS", "OW", "OX", "OY", "PA", "PE", "PI", "QI", "RE", "SH", "SI", "SO",
+    "TA", "TI", "TO", "UH", "UM", "UN", "UP", "US", "UT", "WE", "WO", "XI", "XU", "YA", "YE", "YO",
+    "ZA",
+    "ACE", "ACT", "AID", "AIR", "ALE", "ANE", "ANT", "ARE", "ART", "ATE", "BAT", "BET", "CAR", "CAT",
+    "DOG", "EAR", "EAT", "ERA", "ETA", "GIN", "ION", "IRE", "JAR", "NET", "NIT", "NOR", "NOT", "OAT",
+    "ONE", "ORE", "QAT", "RAN", "RAT", "RET", "SAT", "SEA", "SET", "SIN", "SIR", "SIT", "SON", "TAN",
+    "TAR", "TEA", "TEN", "TIE", "TIN", "TOE", "TON", "ZAX", "ZIT",
+    "ACES", "ACTS", "AIRS", "ANTE", "ANTI", "ANTS", "ARTS", "CARS", "CART", "CAST", "CATS", "DOGS",
+    "EARN", "EARS", "EAST", "EATS", "ERAS", "IONS", "IRES", "NEAT", "NEST", "NETS", "NITS", "NOTE",
+    "OATS", "ONES", "QATS", "QUIT", "QUIZ", "RAIN", "RANT", "RATE", "RATS", "REST", "RIOT", "SANE",
+    "SATE", "SEAT", "SENT", "SITE", "STAR", "TARS", "TEAR", "TEAS", "TENS", "TIES", "TINE", "TINS",
+    "TOES", "TONE", "ZITS",
+    "ANISE", "ASTER", "CARTS", "CASTE", "CRATE", "EARNS", "INERT", "IRATE", "NOTES", "RAINS", "RATES",
+    "REACT", "RESIN", "RINSE", "RISEN", "SATIN", "SIREN", "STAIN", "STARE", "STEIN", "TEARS", "TRACE",
+    "TRAIN", "TRIES",
+    "INSERT", "RETAIN", "RETINA", "SINTER", "STAIRS", "TRAINS", "ESTRIN", "INERTS", "NITERS",
+    "ANESTRI", "NASTIER", "RATINES", "RETAINS", "RETINAS", "STAINER", "STEARIN", "CANISTER",
+};
+
+// Standard 15x15 premium layout: D/T double/triple word, d/t double/triple letter
+const char *const kPremium[kBoardDim] = {
+    "T..d...T...d..T", ".D...t...t...D.", "..D...d.d...D..", "d..D...d...D..d",
+    "....D.....D....", ".t...t...t...t.", "..d...d.d...d..", "T..d...D...d..T",
+    "..d...d.d...d..", ".t...t...t...t.", "....D.....D....", "d..D...d...D..d",
+    "..D...d.d...D..", ".D...t...t...D.", "T..d...T...d..T",
+};
+const int kTileScores[26] = {1, 3, 3, 2, 1, 4, 2, 4, 1, 8, 5, 1, 3, 1, 1, 3, 10, 1, 1, 1, 1, 4, 4, 8, 4, 10};
+
+// Every word as its GADDAG strings in a plain trie: each node's children are
+// contiguous and sorted, the last one flagged, as in Quackle's GADDAG
+class TestGaddag {
+public:
+    struct Arc {
+        uint8_t letter = 0;
+        bool terminal = false;
+        bool last = true;
+        int first = -1;  // first child, -1 for none
+    };
+    using Node = const Arc *;
+
+    explicit TestGaddag(const std::vector<std::string> &words) {
+        Trie root;
+        for (const std::string &word : words) {
+            const int n = static_cast<int>(word.size());
+            for (int pivot = 1; pivot <= n; ++pivot) {
+                Trie *t = &root;
+                for (int i = pivot - 1; i >= 0; --i) t = t->at(static_cast<uint8_t>(word[i] - 'A' + 1));
+                if (pivot < n) t = t->at(kSeparator);
+                for (int i = pivot; i < n; ++i) t = t->at(static_cast<uint8_t>(word[i] - 'A' + 1));
+                t->terminal = true;
+            }
+        }
+        // Breadth first, so every sibling run is contiguous
+        m_arcs.emplace_back();
+        std::vector<std::pair<const Trie *, int>> queue{{&root, 0}};
+        for (size_t q = 0; q < queue.size(); ++q) {
+            const Trie *t = queue[q].first;
+            if (t->children.empty()) continue;
+            const int first = static_cast<int>(m_arcs.size());
+            m_arcs[queue[q].second].first = first;
+            for (const auto &child : t->children) {
+                Arc arc;
+                arc.letter = child.first;
+                arc.terminal = child.second->terminal;
+                arc.last = false;
+                queue.emplace_back(child.second.get(), static_cast<int>(m_arcs.size()));
+                m_arcs.push_back(arc);
+            }
+            m_arcs.back().last = true;
+        }
+    }
+
+    size_t size() const { return m_arcs.size(); }  // nodes, root included
+    Node root() const { return &m_arcs[0]; }
+    Node first_child(Node node) const { return node->first < 0 ? nullptr : &m_arcs[node->first]; }
+    Node next_sibling(Node node) const { return node->last ? nullptr : node + 1; }
+    uint8_t letter(Node node) const { return node->letter; }
+    bool terminal(Node node) const { return node->terminal; }
+    Node child(Node node, uint8_t letter) const {
+        for (Node n = first_child(node); n && n->letter <= letter; n = next_sibling(n))
+            if (n->letter == letter) return n;
+        return nullptr;
+    }
+
+private:
+    struct Trie {
+        std::map<uint8_t, std::unique_ptr<Trie>> children;
+        bool terminal = false;
+
+        Trie *at(uint8_t letter) {
+            std::unique_ptr<Trie> &child = children[letter];
+            if (!child) child.reset(new Trie);
+            return child.get();
+        }
+    };
+
+    std::vector<Arc> m_arcs;
+};
+
+Rules english_rules() {
+    Rules rules;
+    for (int l = 0; l < 26; ++l) rules.tile_score[l + 1] = kTileScores[l];
+    for (int row = 0; row < kBoardDim; ++row) {
+        for (int col = 0; col < kBoardDim; ++col) {
+            const char c = kPremium[row][col];
+            rules.letter_mult[row][col] = c == 'd' ? 2 : c == 't' ? 3 : 1;
+            rules.word_mult[row][col] = c == 'D' ? 2 : c == 'T' ? 3 : 1;
+        }
+    }
+    return rules;
+}
+
+// Not the published Super layout, just premiums spread over the whole 21x21
+// board, symmetric like the real one
+BasicRules<kSuperBoardDim> super_rules() {
+    BasicRules<kSuperBoardDim> rules;
+    for (int l = 0; l < 26; ++l) rules.tile_score[l + 1] = kTileScores[l];
+    for (int row = 0; row < kSuperBoardDim; ++row) {
+        for (int col = 0; col < kSuperBoardDim; ++col) {
+            const bool diagonal = row == col || row + col == kSuperBoardDim - 1;
+            rules.word_mult[row][col] = diagonal ? (row % 10 == 0 ? 3 : 2) : 1;
+            const bool triple = row % 5 == 2 && col % 5 == 2;
+            rules.letter_mult[row][col] = diagonal ? 1 : triple ? 3 : (row + col) % 6 == 0 ? 2 : 1;
+        }
+    }
+    return rules;
+}
+
+// Arbitrary but uneven, so equity and score rankings differ
+double leave_value(const RackCounts &leave) {
+    double value = leave.size * 0.75 + leave.blanks * 4.5 + leave.counts['S' - 'A' + 1] * 2.25;
+    for (int l = 1; l < kMaxLetters; ++l)
+        if (leave.counts[l] > 1) value -= 1.5 * (leave.counts[l] - 1);
+    return value - leave.counts['Q' - 'A' + 1] * 6.0;
+}
+
+int g_checks = 0;
+int g_failures = 0;
+
+void check(bool ok, const std::string &what) {
+    ++g_checks;
+    if (ok) return;
+    if (++g_failures <= 20) std::fprintf(stderr, "FAIL %s\n", what.c_str());
+}
+
+template <int Dim>
+bool same(const BasicCandidate<Dim> &a, const BasicCandidate<Dim> &b) {
+    return a.letters_lo == b.letters_lo && a.letters_hi == b.letters_hi && a.blank_mask == b.blank_mask &&
+           a.through_mask == b.through_mask && a.row == b.row && a.col == b.col && a.dir_length == b.dir_length &&
+           a.placed == b.placed && a.score == b.score && a.equity == b.equity;
+}
+
+template <class Moves, class All>
+bool same_prefix(const Moves &got, const All &all, size_t count) {
+    if (got.size() != count) return false;
+    for (size_t i = 0; i < count; ++i)
+        if (!same(got[i], all[i])) return false;
+    return true;
+}
+
+// Placement written out: direction, start, then each tile with '*' after a
+// blank and '.' after a board tile
+std::string play_key(bool across, int row, int col, const std::vector<uint8_t> &tiles) {
+    std::string key = (across ? "H" : "V") + std::to_string(row) + "," + std::to_string(col) + ":";
+    for (uint8_t t : tiles) {
+        key += static_cast<char>('A' + tile_letter(t) - 1);
+        if (tile_is_blank(t)) key += '*';
+        if (tile_is_through(t)) key += '.';
+    }
+    return key;
+}
+
+template <int Dim>
+std::string play_key(const BasicCandidate<Dim> &c) {
+    std::vector<uint8_t> tiles;
+    for (int i = 0; i < c.length(); ++i) tiles.push_back(c.tile(i));
+    return play_key(c.horizontal(), c.row, c.col, tiles);
+}
+
+// Every legal play by trying every assignment of the rack to every run of
+// squares, keyed by play_key, with its score. Follows the generator's
+// conventions: a single tile forming words both ways is listed across
+// (down if constraints rule the across word out), and an opening on a
+// diagonally symmetric board is listed across only.
+template <int Dim>
+class BruteForce {
+public:
+    BruteForce(const std::unordered_set<std::string> &words, const BasicRules<Dim> &rules)
+        : m_words(words), m_rules(rules) {}
+
+    std::map<std::string, int> plays(const BasicBoardState<Dim> &board, const RackCounts &rack,
+                                     const GenConstraints *constraints = nullptr) {
+        m_board = &board;
+        m_constraints = constraints;
+        m_out.clear();
+        const bool mirror_opening =
+            board.empty() && m_rules.symmetric_about_diagonal() &&
+            (!constraints || (constraints->allows_direction(0) && constraints->cover_row == constraints->cover_col));
+        for (int dir = 0; dir < 2 - mirror_opening; ++dir)
+            for (int line = 0; line < Dim; ++line)
+                for (int start = 0; start < Dim; ++start)
+                    for (int end = start + 1; end < Dim; ++end) run(dir, line, start, end, rack);
+        return m_out;
+    }
+
+private:
+    const Square &at(int dir, int line, int pos) const { return m_board->at(dir, line, pos); }
+
+    void run(int dir, int line, int start, int end, const RackCounts &rack) {
+        if (start > 0 && at(dir, line, start - 1).tile) return;
+        if (end + 1 < Dim && at(dir, line, end + 1).tile) return;
+        m_empties.clear();
+        bool anchored = false;
+        for (int pos = start; pos <= end; ++pos) {
+            if (at(dir, line, pos).tile) continue;
+            m_empties.push_back(pos);
+            anchored |= at(dir, line, pos).anchor;
+        }
+        if (m_empties.empty() || static_cast<int>(m_empties.size()) > rack.size || !anchored) return;
+        if (dir == 1 && m_empties.size() == 1 && listed_across(m_empties[0], line)) return;
+        m_dir = dir;
+        m_line = line;
+        m_start = start;
+        m_end = end;
+        m_rack = rack;
+        m_tiles.assign(end - start + 1, 0);
+        assign(0);
+    }
+
+    bool listed_across(int row, int col) const {
+        int first = col;
+        while (first > 0 && m_board->tile(row, first - 1)) --first;
+        int last = col;
+        while (last + 1 < Dim && m_board->tile(row, last + 1)) ++last;
+        if (first == last) return false;
+        return !m_constraints || m_constraints->allows_word(row, first, true, last - first + 1);
+    }
+
+    bool allowed() const {
+        const GenConstraints &c = *m_constraints;
+        const int row = BasicBoardState<Dim>::row_of(m_dir, m_line, m_start);
+        const int col = BasicBoardState<Dim>::col_of(m_dir, m_line, m_start);
+        if (!c.allows_word(row, col, m_dir == 0, m_end - m_start + 1)) return false;
+        if (c.use_all && static_cast<int>(m_empties.size()) != m_rack.size) return false;
+        int placed[kMaxLetters] = {};
+        for (int pos : m_empties) ++placed[tile_letter(m_tiles[pos - m_start])];
+        for (int l = 0; l < kMaxLetters; ++l)
+            if (placed[l] < c.must_use.counts[l]) return false;
+        return true;
+    }
+
+    void assign(size_t i) {
+        if (i == m_empties.size()) {
+            score();
+            return;
+        }
+        uint8_t &tile = m_tiles[m_empties[i] - m_start];
+        for (uint8_t l = 1; l <= 26; ++l) {
+            if (m_rack.counts[l]) {
+                --m_rack.counts[l];
+                tile = l;
+                assign(i + 1);
+                ++m_rack.counts[l];
+            }
+            if (m_rack.blanks) {
+                --m_rack.blanks;
+                tile = l | kBlankBit;
+                assign(i + 1);
+                ++m_rack.blanks;
+            }
+        }
+    }
+
+    void score() {
+        std::string word;
+        for (int pos = m_start; pos <= m_end; ++pos) {
+            const uint8_t board_tile = at(m_dir, m_line, pos).tile;
+            if (board_tile) m_tiles[pos - m_start] = board_tile | kThroughBit;
+            word += static_cast<char>('A' + tile_letter(m_tiles[pos - m_start]) - 1);
+        }
+        if (!m_words.count(word)) return;
+        if (m_constraints && !allowed()) return;
+
+        int main = 0;
+        int word_mult = 1;
+        int cross = 0;
+        const int perp = 1 - m_dir;
+        for (int pos = m_start; pos <= m_end; ++pos) {
+            const uint8_t tile = m_tiles[pos - m_start];
+            const int face = tile_is_blank(tile) ? 0 : m_rules.tile_score[tile_letter(tile)];
+            if (tile_is_through(tile)) {
+                main += face;
+                continue;
+            }
+            const int row = BasicBoardState<Dim>::row_of(m_dir, m_line, pos);
+            const int col = BasicBoardState<Dim>::col_of(m_dir, m_line, pos);
+            const int lm = m_rules.letter_mult[row][col];
+            const int wm = m_rules.word_mult[row][col];
+            main += face * lm;
+            word_mult *= wm;
+
+            int first = m_line;
+            while (first > 0 && at(perp, pos, first - 1).tile) --first;
+            int last = m_line;
+            while (last + 1 < Dim && at(perp, pos, last + 1).tile) ++last;
+            if (first == last) continue;
+            std::string cross_word;
+            int cross_face = 0;
+            for (int p = first; p <= last; ++p) {
+                const uint8_t t = p == m_line ? tile : at(perp, pos, p).tile;
+                cross_word += static_cast<char>('A' + tile_letter(t) - 1);
+                if (p != m_line && !tile_is_blank(t)) cross_face += m_rules.tile_score[tile_letter(t)];
+            }
+            if (!m_words.count(cross_word)) return;
+            cross += (cross_face + face * lm) * wm;
+        }
+        const int placed = static_cast<int>(m_empties.size());
+        const int total = main * word_mult + cross + (placed == m_rules.rack_size ? m_rules.bingo_bonus : 0);
+        m_out[play_key(m_dir == 0, BasicBoardState<Dim>::row_of(m_dir, m_line, m_start),
+                       BasicBoardState<Dim>::col_of(m_dir, m_line, m_start), m_tiles)] = total;
+    }
+
+    const std::unordered_set<std::string> &m_words;
+    const BasicRules<Dim> &m_rules;
+    const BasicBoardState<Dim> *m_board = nullptr;
+    const GenConstraints *m_constraints = nullptr;
+    int m_dir = 0;
+    int m_line = 0;
+    int m_start = 0;
+    int m_end = 0;
+    RackCounts m_rack;
+    std::vector<int> m_empties;
+    std::vector<uint8_t> m_tiles;
+    std::map<std::string, int> m_out;
+};
+
+template <int Dim>
+RackCounts leave_of(const RackCounts &rack, const BasicCandidate<Dim> &c) {
+    RackCounts leave = rack;
+    for (int i = 0; i < c.length(); ++i) {
+        const uint8_t t = c.tile(i);
+        if (tile_is_through(t)) continue;
+        if (tile_is_blank(t)) --leave.blanks;
+        else --leave.counts[tile_letter(t)];
+        --leave.size;
+    }
+    return leave;
+}
+
+GenOptions options(int top_n, bool prune = false) {
+    GenOptions out;
+    out.top_n = top_n;
+    out.prune = prune;
+    return out;
+}
+
+// Copies the moves out and rewinds the arena, as the engine does per reply
+template <class Graph, int Dim>
+std::vector<BasicCandidate<Dim>> generate(const Graph &graph, const BasicBoardState<Dim> &board,
+                                          const BasicRules<Dim> &rules, const RackCounts &rack,
+                                          const LeaveTable &leaves, WorkPool *pool, const GenOptions &options,
+                                          BasicGenWorkspace<Dim> &ws) {
+    const auto moves = generate_moves(graph, board, rules, rack, leaves, pool, options, ws);
+    std::vector<BasicCandidate<Dim>> out(moves.begin(), moves.end());
+    ws.arena.rewind();
+    return out;
+}
+
+// One position: the full list against brute force, then every cut of it.
+// The full list comes from a fresh workspace and the cuts from `ws`, which
+// is reused across positions.
+template <class Graph, int Dim>
+void check_position(const char *name, const Graph &graph, BasicBoardState<Dim> board, const BasicRules<Dim> &rules,
+                    const std::string &rack_text, BruteForce<Dim> &brute, WorkPool &pool,
+                    BasicGenWorkspace<Dim> &ws) {
+    board.prepare(graph, rules);
+    const RackCounts rack = rack_from_string(rack_text);
+    const LeaveTable leaves(rack, leave_value);
+    const std::string where = std::string(name) + " tiles=" + std::to_string(board.tile_count()) + " rack=" + rack_text;
+
+    BasicGenWorkspace<Dim> fresh;
+    const std::vector<BasicCandidate<Dim>> all =
+        generate(graph, board, rules, rack, leaves, nullptr, options(0), fresh);
+    std::map<std::string, int> generated;
+    std::unordered_set<uint64_t> keys;
+    for (const BasicCandidate<Dim> &c : all) {
+        const std::string key = play_key(c);
+        check(generated.emplace(key, c.score).second, where + ": duplicate " + key);
+        check(keys.insert(candidate_key(c)).second, where + ": key collision at " + key);
+        const int32_t equity =
+            c.score * static_cast<int32_t>(kEquityScale) + equity_fixed(leave_value(leave_of(rack, c)));
+        check(c.equity == equity, where + ": equity of " + key);
+    }
+    const std::map<std::string, int> expected = brute.plays(board, rack);
+    check(all.size() == expected.size(), where + ": " + std::to_string(all.size()) + " plays, expected " +
+                                             std::to_string(expected.size()));
+    for (const auto &play : expected) {
+        auto it = generated.find(play.first);
+        check(it != generated.end(), where + ": missing " + play.first);
+        if (it != generated.end()) check(it->second == play.second, where + ": score of " + play.first);
+    }
+    for (const auto &play : generated) check(expected.count(play.first) != 0, where + ": extra " + play.first);
+
+    for (int top_n : {1, 10, 1000}) {
+        const size_t count = std::min(static_cast<size_t>(top_n), all.size());
+        const std::string cut = where + " top=" + std::to_string(top_n);
+        for (bool prune : {false, true}) {
+            const std::string mode = cut + (prune ? " pruned" : "");
+            const GenOptions cut_options = options(top_n, prune);
+            check(same_prefix(generate(graph, board, rules, rack, leaves, nullptr, cut_options, ws), all, count),
+                  mode + ": serial top-K");
+            check(same_prefix(generate(graph, board, rules, rack, leaves, &pool, cut_options, ws), all, count),
+                  mode + ": pool top-K");
+        }
+
+        // Ranked by score: the leave table is never read, so it matches an
+        // empty table, and scores never increase down the list
+        GenOptions by_score = options(top_n, true);
+        by_score.rank_by = RankBy::Score;
+        const LeaveTable none;
+        const std::vector<BasicCandidate<Dim>> scored =
+            generate(graph, board, rules, rack, leaves, &pool, by_score, ws);
+        const std::vector<BasicCandidate<Dim>> unvalued =
+            generate(graph, board, rules, rack, none, nullptr, options(top_n), ws);
+        check(same_prefix(scored, unvalued, unvalued.size()), cut + ": score ranking");
+        bool ordered = scored.size() == count;
+        for (size_t i = 1; i < scored.size(); ++i) ordered &= scored[i].score <= scored[i - 1].score;
+        check(ordered, cut + ": score order");
+    }
+}
+
+// Plays generated under each kind of constraint match the brute force held
+// to the same constraint, and a bounded run is a prefix of the full one
+template <class Graph, int Dim>
+void check_constraints(const char *name, const Graph &graph, BasicBoardState<Dim> board,
+                       const BasicRules<Dim> &rules, const std::string &rack_text, BruteForce<Dim> &brute,
+                       BasicGenWorkspace<Dim> &ws) {
+    board.prepare(graph, rules);
+    const RackCounts rack = rack_from_string(rack_text);
+    const LeaveTable leaves(rack, leave_value);
+    std::vector<std::pair<std::string, GenConstraints>> cases(7);
+    cases[0].first = "across";
+    cases[0].second.directions = GenConstraints::kAcross;
+    cases[1].first = "down";
+    cases[1].second.directions = GenConstraints::kDown;
+    cases[2].first = "cover";
+    cases[2].second.cover_row = rules.center_row;
+    cases[2].second.cover_col = rules.center_col + 1;
+    cases[3].first = "min 4";
+    cases[3].second.min_length = 4;
+    cases[4].first = "max 3";
+    cases[4].second.max_length = 3;
+    cases[5].first = "must use";
+    cases[5].second.must_use.add(static_cast<uint8_t>(rack_text[0] - 'A' + 1));
+    cases[6].first = "use all";
+    cases[6].second.use_all = true;
+
+    for (const auto &test : cases) {
+        const std::string where = std::string(name) + " tiles=" + std::to_string(board.tile_count()) +
+                                  " rack=" + rack_text + " " + test.first;
+        GenOptions constrained = options(0);
+        constrained.constraints = test.second;
+        const std::vector<BasicCandidate<Dim>> all =
+            generate(graph, board, rules, rack, leaves, nullptr, constrained, ws);
+        std::map<std::string, int> generated;
+        for (const BasicCandidate<Dim> &c : all)
+            check(generated.emplace(play_key(c), c.score).second, where + ": duplicate " + play_key(c));
+        check(generated == brute.plays(board, rack, &test.second), where + ": plays differ from brute force");
+
+        constrained.top_n = 10;
+        constrained.prune = true;
+        check(same_prefix(generate(graph, board, rules, rack, leaves, nullptr, constrained, ws), all,
+                          std::min<size_t>(10, all.size())),
+              where + ": top-K");
+    }
+}
+
+// Boards reached by playing the best move of random racks
+template <class Graph, int Dim>
+std::vector<BasicBoardState<Dim>> positions(const Graph &graph, const BasicRules<Dim> &rules) {
+    const char *const bag = "AAAAEEEEEIIIIOOONNNRRRSSTTTLCDGHMPUBZQX";
+    std::mt19937 rng(2024);
+    std::vector<BasicBoardState<Dim>> out;
+    BasicBoardState<Dim> board;
+    const LeaveTable none;
+    BasicGenWorkspace<Dim> ws;
+    out.push_back(board);
+    for (int turn = 0; out.size() < 8 && turn < 40; ++turn) {
+        std::string rack;
+        for (int i = 0; i < 7; ++i) rack += bag[rng() % std::strlen(bag)];
+        board.prepare(graph, rules);
+        const std::vector<BasicCandidate<Dim>> best =
+            generate(graph, board, rules, rack_from_string(rack), none, nullptr, options(1), ws);
+        if (best.empty()) continue;
+        const BasicCandidate<Dim> &c = best[0];
+        for (int i = 0; i < c.length(); ++i)
+            board.set_tile(c.row + (c.horizontal() ? 0 : i), c.col + (c.horizontal() ? i : 0), tile_letter(c.tile(i)));
+        out.push_back(board);
+    }
+    return out;
+}
+
+// Every tile encoding at every position survives packing, without
+// disturbing the tiles around it
+template <int Dim>
+void check_candidate_packing() {
+    for (int i = 0; i < Dim; ++i) {
+        for (uint8_t flags : {uint8_t(0), kBlankBit, kThroughBit}) {
+            for (uint8_t letter = 1; letter <= 26; ++letter) {
+                BasicCandidate<Dim> c;
+                c.set_placement(Dim - 1, 0, false, Dim);
+                for (int j = 0; j < Dim; ++j) c.set_tile(j, 26 | kThroughBit);
+                c.set_tile(i, letter | flags);
+                bool ok = c.tile(i) == (letter | flags) && !c.horizontal() && c.length() == Dim;
+                for (int j = 0; j < Dim; ++j) ok &= j == i || c.tile(j) == (26 | kThroughBit);
+                check(ok, "packing of tile " + std::to_string(i));
+            }
+        }
+    }
+}
+
+// Cursors find their lists until the TTL lapses without a hit, and the
+// least recently used lists give way to the entry and move bounds
+void check_move_store() {
+    using Clock = MoveStore::Clock;
+    const Clock::time_point t0{};
+    const auto list = [](size_t n) {
+        std::vector<Candidate> moves(n);
+        for (size_t i = 0; i < n; ++i) moves[i].score = static_cast<int16_t>(i);
+        return moves;
+    };
+    const auto at = [&](int seconds) { return t0 + std::chrono::seconds(seconds); };
+
+    MoveStore by_entries(2, 100, std::chrono::seconds(60));
+    const std::string a = by_entries.put(list(4), at(0));
+    const std::string b = by_entries.put(list(4), at(10));
+    check(!a.empty() && !b.empty() && a != b && by_entries.moves() == 8, "move store: put");
+    const std::vector<Candidate> *got = by_entries.get(a, at(20));
+    check(got && got->size() == 4 && (*got)[3].score == 3, "move store: get");
+    // b is now the least recently used
+    const std::string c = by_entries.put(list(2), at(30));
+    check(by_entries.entries() == 2 && !by_entries.get(b, at(30)) && by_entries.get(a, at(30)) &&
+              by_entries.get(c, at(30)),
+          "move store: entry bound");
+    // A hit restarts the TTL; a lapsed one drops the list
+    check(by_entries.get(a, at(89)) && !by_entries.get(c, at(91)) && by_entries.get(a, at(91)) &&
+              by_entries.moves() == 4,
+          "move store: ttl");
+
+    MoveStore by_moves(10, 10, std::chrono::seconds(60));
+    const std::string d = by_moves.put(list(4), at(0));
+    const std::string e = by_moves.put(list(4), at(1));
+    by_moves.get(d, at(2));
+    const std::string f = by_moves.put(list(4), at(3));
+    check(by_moves.entries() == 2 && by_moves.moves() == 8 && by_moves.get(d, at(3)) && !by_moves.get(e, at(3)) &&
+              by_moves.get(f, at(3)),
+          "move store: move bound");
+    check(by_moves.put(list(11), at(4)).empty() && by_moves.entries() == 2, "move store: oversized list kept");
+}
+
+// A snapshot outlives the publish that replaces it, and the old value goes
+// with the last snapshot; readers racing a writer only ever see values it
+// published, in order
+void check_published() {
+    struct Value {
+        Value(int n, bool *freed) : n(n), freed(freed) {}
+        ~Value() {
+            if (freed) *freed = true;
+        }
+        int n;
+        bool *freed;
+    };
+    bool freed = false;
+    Published<Value> published;
+    check(!published.acquire(), "published: value before the first publish");
+    published.publish(std::make_shared<const Value>(1, &freed));
+    std::shared_ptr<const Value> snapshot = published.acquire();
+    published.publish(std::make_shared<const Value>(2, nullptr));
+    check(snapshot->n == 1 && !freed && published.acquire()->n == 2, "published: snapshot replaced under a reader");
+    snapshot.reset();
+    check(freed, "published: old value kept after the last snapshot");
+
+    Published<int> counter(std::make_shared<const int>(0));
+    const int kLast = 20000;
+    std::atomic<bool> ordered{true};
+    std::vector<std::thread> readers;
+    for (int r = 0; r < 2; ++r) {
+        readers.emplace_back([&] {
+            for (int seen = 0; seen < kLast;) {
+                const int now = *counter.acquire();
+                if (now < seen) ordered = false;
+                seen = now;
+            }
+        });
+    }
+    for (int i = 1; i <= kLast; ++i) counter.publish(std::make_shared<const int>(i));
+    for (std::thread &t : readers) t.join();
+    check(ordered, "published: a reader went back in time");
+}
+
+// Every leave of up to kMaxLeaveTiles tiles once, types in increasing order
+// (0 is the blank)
+void for_each_leave(RackCounts &leave, int from, const std::function<void(const RackCounts &)> &fn) {
+    fn(leave);
+    if (leave.size == kMaxLeaveTiles) return;
+    for (int type = from; type < kLeaveTypes; ++type) {
+        if (type == 0) leave.add_blank();
+        else leave.add(static_cast<uint8_t>(type));
+        for_each_leave(leave, type, fn);
+        if (type == 0) --leave.blanks;
+        else --leave.counts[type];
+        --leave.size;
+    }
+}
+
+// leave_rank numbers the leaves 0..kLeaveCount-1, and a written table reads
+// back through the mapping
+void check_leave_file(const std::string &dir) {
+    std::vector<bool> seen(kLeaveCount);
+    size_t leaves = 0;
+    bool in_range = true;
+    bool distinct = true;
+    RackCounts leave;
+    for_each_leave(leave, 0, [&](const RackCounts &l) {
+        const uint32_t rank = leave_rank(l);
+        ++leaves;
+        if (rank >= kLeaveCount) {
+            in_range = false;
+            return;
+        }
+        distinct &= !seen[rank];
+        seen[rank] = true;
+    });
+    check(leaves == kLeaveCount && in_range && distinct, "leave_rank is not a bijection");
+
+    std::vector<int32_t> values(kLeaveCount);
+    for (uint32_t i = 0; i < kLeaveCount; ++i) values[i] = static_cast<int32_t>(i % 20011) * 37 - 370000;
+    const std::string path = dir + "/gen_test_" + std::to_string(getpid()) + ".leaves";
+    std::string error;
+    MappedLeaves mapped;
+    check(write_leave_file(path, values, error), "leave file: " + error);
+    // Read through the file mapping, then through a private huge-page copy
+    for (bool copy : {false, true}) {
+        check(mapped.open(path, error), "leave file: " + error);
+        if (!mapped.loaded()) continue;
+        if (copy) {
+            ResidencyOptions residency;
+            residency.huge_pages = true;
+            mapped.apply_residency(residency);
+            check(mapped.residency().copied, "leave file: not copied: " + mapped.residency().error);
+        }
+        bool same_values = true;
+        for_each_leave(leave, 0, [&](const RackCounts &l) { same_values &= mapped.fixed(l) == values[leave_rank(l)]; });
+        check(same_values, "leave file values");
+        check(mapped.fixed(rack_from_string("AEINRST")) == 0, "leave file: whole rack");
+        mapped.close();
+    }
+
+    // A table of another shape is refused
+    if (std::FILE *f = std::fopen(path.c_str(), "r+b")) {
+        const uint32_t version = kLeaveFileVersion + 1;
+        std::fseek(f, offsetof(LeaveFileHeader, version), SEEK_SET);
+        std::fwrite(&version, sizeof(version), 1, f);
+        std::fclose(f);
+    }
+    check(!mapped.open(path, error), "leave file: wrong version accepted");
+    std::remove(path.c_str());
+}
+
+// The best exchange against every kept subset of the rack
+void check_exchange(const std::string &rack_text) {
+    const RackCounts rack = rack_from_string(rack_text);
+    const LeaveTable leaves(rack, leave_value);
+    Exchange exchange;
+    const bool found = best_exchange(rack, leaves, exchange);
+    check(found, "exchange " + rack_text + ": none found");
+    if (!found) return;
+
+    const int n = static_cast<int>(rack_text.size());
+    double best = 0.0;
+    for (uint32_t mask = 0; mask + 1 < (1u << n); ++mask) {
+        RackCounts keep;
+        for (int i = 0; i < n; ++i) {
+            if (!(mask >> i & 1u)) continue;
+            if (rack_text[i] == '?') keep.add_blank();
+            else keep.add(static_cast<uint8_t>(rack_text[i] - 'A' + 1));
+        }
+        best = mask ? std::max(best, leave_value(keep)) : leave_value(keep);
+    }
+    check(exchange.equity == equity_fixed(best), "exchange " + rack_text + ": equity");
+    check(exchange.tiles.size >= 1 && exchange.tiles.size + exchange.keep.size == rack.size,
+          "exchange " + rack_text + ": tiles");
+    check(equity_fixed(leave_value(exchange.keep)) == exchange.equity, "exchange " + rack_text + ": kept leave");
+}
+
+template <class Graph, int Dim>
+void check_graph(const char *name, const Graph &graph, const std::vector<BasicBoardState<Dim>> &boards,
+                 const BasicRules<Dim> &rules, BruteForce<Dim> &brute, WorkPool &pool) {
+    BasicGenWorkspace<Dim> ws;
+    // The brute force tries every assignment, so racks with blanks stay short
+    check_position(name, graph, boards[0], rules, "AEINRST", brute, pool, ws);
+    check_position(name, graph, boards[0], rules, "AEINRS?", brute, pool, ws);
+    check_position(name, graph, boards[0], rules, "ERA??", brute, pool, ws);
+    for (size_t b = 1; b < boards.size(); ++b) {
+        for (const char *rack : {"CATS", "ETA?", "T??", "ZAXQI", "RETINAS"}) {
+            // Seven tiles only where few runs are open
+            if (std::strlen(rack) == 7 && b > 2) continue;
+            check_position(name, graph, boards[b], rules, rack, brute, pool, ws);
+        }
+    }
+    check_constraints(name, graph, boards[0], rules, "AEINRST", brute, ws);
+    for (size_t b = 1; b < boards.size(); ++b) check_constraints(name, graph, boards[b], rules, "SETA?", brute, ws);
+}
+
+// The trie packed into a mapped file walks to the same plays, with no child
+// run that fits a cache line straddling two; a file with a child run past
+// its end is refused
+void check_mapped_graph(const std::string &dir, const TestGaddag &gaddag, const std::vector<BoardState> &boards,
+                        const Rules &rules, BruteForce<kBoardDim> &brute, WorkPool &pool) {
+    const std::string path = dir + "/gen_test_" + std::to_string(getpid()) + ".wgaddag";
+    std::vector<MappedNode> nodes;
+    std::string error;
+    MappedGraph mapped;
+    check(pack_graph(gaddag, nodes, error) && write_mapped_nodes(path, nodes, error) && mapped.open(path, error),
+          "mapped graph: " + error);
+    if (mapped.loaded()) check_graph("mapped", mapped, boards, rules, brute, pool);
+    mapped.close();
+
+    bool aligned = true;
+    for (const MappedNode &node : nodes) {
+        const size_t run = static_cast<size_t>(__builtin_popcount(node.mask & kMappedLetterMask));
+        const size_t first = node.link & kMappedIndexMask;
+        if (run && run <= kMappedLineNodes) aligned &= first % kMappedLineNodes + run <= kMappedLineNodes;
+    }
+    check(aligned, "mapped graph: a child run straddles a cache line");
+
+    // A compact file is smaller and expands to the same nodes
+    check(write_mapped_nodes(path, nodes, error, true) && mapped.open(path, error), "mapped graph: compact: " + error);
+    if (mapped.loaded()) {
+        struct stat st{};
+        check(::stat(path.c_str(), &st) == 0 &&
+                  static_cast<size_t>(st.st_size) == mapped_file_bytes(nodes.size(), true) &&
+                  mapped_file_bytes(nodes.size(), true) < mapped_file_bytes(nodes.size(), false) &&
+                  mapped.node_count() == nodes.size() &&
+                  std::memcmp(mapped.root(), nodes.data(), nodes.size() * sizeof(MappedNode)) == 0,
+              "mapped graph: compact file differs");
+        mapped.close();
+    }
+    check(write_mapped_nodes(path, nodes, error), "mapped graph: " + error);
+
+    // A locked huge-page copy holds the same nodes, all in memory; locking
+    // may be refused under a low RLIMIT_MEMLOCK, which only leaves an error
+    ResidencyOptions residency;
+    residency.huge_pages = true;
+    residency.lock = true;
+    if (mapped.open(path, error)) {
+        mapped.apply_residency(residency);
+        check(mapped.residency().copied && mapped.resident_bytes() == mapped.bytes() &&
+                  std::memcmp(mapped.root(), nodes.data(), nodes.size() * sizeof(MappedNode)) == 0,
+              "mapped graph: huge-page copy differs: " + mapped.residency().error);
+        mapped.close();
+    }
+
+    nodes[1] = mapped_node(1u << 1, static_cast<uint32_t>(nodes.size()), 1, false, false);
+    check(write_mapped_nodes(path, nodes, error) && !mapped.open(path, error), "mapped graph: corrupt file accepted");
+    std::remove(path.c_str());
+}
+
+// Lexica map on first use, the least recently used one goes once the cap
+// is passed, and a graph still held outlives its eviction
+void check_lexicon_registry(const std::string &dir, const TestGaddag &gaddag) {
+    const std::string base = dir + "/gen_test_" + std::to_string(getpid());
+    std::vector<MappedNode> nodes;
+    std::string error;
+    check(pack_graph(gaddag, nodes, error) && write_mapped_nodes(base + ".a.wgaddag", nodes, error) &&
+              write_mapped_nodes(base + ".b.wgaddag", nodes, error),
+          "lexicon registry: " + error);
+    const size_t bytes = sizeof(MappedGraphHeader) + nodes.size() * sizeof(MappedNode);
+
+    LexiconRegistry registry(bytes + bytes / 2);
+    check(registry.add("a", base + ".a.wgaddag") && registry.add("b", base + ".b.wgaddag") &&
+              registry.add("missing", base + ".none"),
+          "lexicon registry: add");
+    check(!registry.add("a", base + ".b.wgaddag") && !registry.add("bad name", base + ".a.wgaddag") &&
+              !registry.add(std::string(33, 'x'), base + ".a.wgaddag"),
+          "lexicon registry: duplicate or malformed name accepted");
+    check(!registry.acquire("unknown", error) && !registry.acquire("missing", error), "lexicon registry: bad lexicon");
+
+    const std::shared_ptr<const MappedGraph> a = registry.acquire("a", error);
+    check(a && a->node_count() == nodes.size() && registry.acquire("a", error) == a &&
+              registry.resident_bytes() == bytes,
+          "lexicon registry: acquire");
+    const std::shared_ptr<const MappedGraph> b = registry.acquire("b", error);
+    bool a_resident = true;
+    uint64_t a_loads = 0;
+    for (const LexiconRegistry::Status &st : registry.status()) {
+        if (st.name != "a") continue;
+        a_resident = st.resident;
+        a_loads = st.loads;
+    }
+    check(b && !a_resident && a_loads == 1 && registry.resident_bytes() == bytes, "lexicon registry: eviction");
+    check(a->loaded() && a->child(a->root(), 'Q' - 'A' + 1), "lexicon registry: evicted graph unmapped while held");
+    check(registry.acquire("a", error) != a, "lexicon registry: evicted graph not remapped");
+
+    // Concurrent first uses share one load, and a failed one fails them all
+    LexiconRegistry shared;
+    check(shared.add("a", base + ".a.wgaddag") && shared.add("missing", base + ".none"), "lexicon registry: add");
+    std::vector<std::shared_ptr<const MappedGraph>> got(8);
+    std::vector<int> missing(got.size());
+    std::vector<std::thread> users;
+    for (size_t t = 0; t < got.size(); ++t)
+        users.emplace_back([&shared, &got, &missing, t] {
+            std::string e;
+            got[t] = shared.acquire("a", e);
+            missing[t] = !shared.acquire("missing", e) && !e.empty();
+        });
+    for (std::thread &u : users) u.join();
+    bool one_graph = true;
+    for (size_t t = 0; t < got.size(); ++t) one_graph &= got[t] && got[t] == got[0] && missing[t];
+    for (const LexiconRegistry::Status &st : shared.status())
+        if (st.name == "a") one_graph &= st.loads == 1 && st.uses == got.size();
+    check(one_graph, "lexicon registry: concurrent first uses");
+    std::remove((base + ".a.wgaddag").c_str());
+    std::remove((base + ".b.wgaddag").c_str());
+}
+
+// A ruleset context takes its scores, board, rack and bingo from its files
+// and spec, refuses racks past kMaxRackTiles, and generates like the brute
+// force held to its rules
+void check_ruleset(const std::string &dir, const TestGaddag &gaddag, const std::unordered_set<std::string> &lexicon,
+                   WorkPool &pool) {
+    const std::string base = dir + "/gen_test_" + std::to_string(getpid());
+    std::vector<MappedNode> nodes;
+    std::string error;
+    check(pack_graph(gaddag, nodes, error) && write_mapped_nodes(base + ".wgaddag", nodes, error),
+          "ruleset: " + error);
+    if (std::FILE *f = std::fopen((base + ".quackle_alphabet").c_str(), "w")) {
+        std::fprintf(f, "# no Q\n");
+        for (int l = 0; l < 26; ++l)
+            if (l != 'Q' - 'A') std::fprintf(f, "%c %c %d 4 0\n", 'A' + l, 'a' + l, kTileScores[l] + 1);
+        std::fprintf(f, "blank 0 2\n");
+        std::fclose(f);
+    }
+    if (std::FILE *f = std::fopen((base + ".board").c_str(), "w")) {
+        for (int row = 0; row < kBoardDim; ++row) {
+            std::string line = kPremium[row];
+            if (row == 7) line[7] = '*';
+            std::fprintf(f, "%s\n", line.c_str());
+        }
+        std::fclose(f);
+    }
+    const std::string files = "alphabet=" + base + ".quackle_alphabet,lexicon=" + base + ".wgaddag,board=" + base +
+                              ".board";
+    const Rules english = english_rules();
+    Rules plain;
+    const ResidencyOptions in_place;
+    RulesetContext context;
+    check(load_ruleset("it:" + files + ",rack=6,bingo=40", plain, in_place, context, error), "ruleset: " + error);
+    bool same_rules = context.rules.rack_size == 6 && context.rules.bingo_bonus == 40 &&
+                      context.rules.center_row == 7 && context.rules.center_col == 7 && context.blanks == 2 &&
+                      !context.has_letter('Q' - 'A' + 1) && context.has_letter('Z' - 'A' + 1);
+    for (int l = 1; l <= 26; ++l)
+        same_rules &= context.rules.tile_score[l] == (l == 'Q' - 'A' + 1 ? 0 : kTileScores[l - 1] + 1);
+    for (int row = 0; row < kBoardDim; ++row)
+        for (int col = 0; col < kBoardDim; ++col)
+            same_rules &= context.rules.letter_mult[row][col] == english.letter_mult[row][col] &&
+                          context.rules.word_mult[row][col] == english.word_mult[row][col];
+    check(same_rules, "ruleset: rules differ from the files");
+
+    RulesetContext rejected;
+    const std::string too_long = ",rack=" + std::to_string(kMaxRackTiles + 1);
+    check(!load_ruleset("it:" + files + too_long, plain, in_place, rejected, error) &&
+              !load_ruleset("i t:" + files, plain, in_place, rejected, error) &&
+              !load_ruleset("it:board=x", plain, in_place, rejected, error),
+          "ruleset: bad spec accepted");
+
+    if (context.graph) {
+        BruteForce<kBoardDim> brute(lexicon, context.rules);
+        GenWorkspace ws;
+        BoardState board;
+        check_position("ruleset", *context.graph, board, context.rules, "AEINRS", brute, pool, ws);
+        board.set_tile(7, 6, 'A' - 'A' + 1);
+        board.set_tile(7, 7, 'T' - 'A' + 1);
+        check_position("ruleset", *context.graph, board, context.rules, "ERA?S", brute, pool, ws);
+    }
+    for (const char *ext : {".wgaddag", ".quackle_alphabet", ".board"}) std::remove((base + ext).c_str());
+}
+
+// Every string a graph accepts, separators as '^'
+template <class Graph>
+void graph_strings(const Graph &graph, typename Graph::Node node, std::string &prefix, std::set<std::string> &out) {
+    for (typename Graph::Node n = graph.first_child(node); n; n = graph.next_sibling(n)) {
+        prefix += graph.letter(n) ? static_cast<char>('A' + graph.letter(n) - 1) : '^';
+        if (graph.terminal(n)) out.insert(prefix);
+        graph_strings(graph, n, prefix, out);
+        prefix.pop_back();
+    }
+}
+
+template <class Graph>
+std::set<std::string> graph_strings(const Graph &graph) {
+    std::set<std::string> out;
+    std::string prefix;
+    graph_strings(graph, graph.root(), prefix, out);
+    return out;
+}
+
+// The built GADDAG accepts exactly the trie's strings, the same graph comes
+// out whatever the thread count and string budget, and it generates like
+// the brute force. A budget of one string runs one shard at a time.
+void check_gaddag_builder(const std::vector<std::string> &words, const TestGaddag &gaddag,
+                          const std::vector<BoardState> &boards, const Rules &rules, BruteForce<kBoardDim> &brute,
+                          WorkPool &pool) {
+    const struct {
+        int threads;
+        size_t max_strings;
+    } runs[] = {{1, GaddagBuilder::kDefaultMaxStrings}, {3, GaddagBuilder::kDefaultMaxStrings}, {3, 1}};
+    std::vector<MappedNode> packed[3];
+    for (size_t r = 0; r < 3; ++r) {
+        GaddagBuilder builder;
+        for (const std::string &word : words) builder.add_word(word);
+        check(!builder.add_word("QU1Z") && !builder.add_word(std::string(GaddagBuilder::kMaxWord + 1, 'A')),
+              "gaddag builder: bad word accepted");
+        builder.build(runs[r].threads, runs[r].max_strings);
+        const GaddagBuilder::Stats &stats = builder.stats();
+        check(stats.words == words.size() && stats.trie_states == gaddag.size() && stats.states < stats.trie_states &&
+                  stats.peak_strings >= stats.largest_shard && stats.peak_strings <= stats.strings,
+              "gaddag builder: stats");
+        if (runs[r].max_strings == 1)
+            check(stats.peak_strings == stats.largest_shard, "gaddag builder: shards in flight over the budget");
+        check(graph_strings(builder) == graph_strings(gaddag), "gaddag builder: strings differ from the trie");
+        std::string error;
+        check(pack_graph(builder, packed[r], error), "gaddag builder: " + error);
+        if (r == 0) check_graph("builder", builder, boards, rules, brute, pool);
+    }
+    for (size_t r = 1; r < 3; ++r)
+        check(packed[0].size() == packed[r].size() &&
+                  std::memcmp(packed[0].data(), packed[r].data(), packed[0].size() * sizeof(MappedNode)) == 0,
+              "gaddag builder: graph depends on the threads or the budget");
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+    const std::string dir = argc > 1 ? argv[1] : ".";
+    const std::vector<std::string> words(std::begin(kWords), std::end(kWords));
+    const std::unordered_set<std::string> lexicon(words.begin(), words.end());
+    const TestGaddag gaddag(words);
+
+    const Rules rules = english_rules();
+    const std::vector<BoardState> boards = positions(gaddag, rules);
+    BruteForce<kBoardDim> brute(lexicon, rules);
+    WorkPool pool(3);
+    check_graph("trie", gaddag, boards, rules, brute, pool);
+    check_mapped_graph(dir, gaddag, boards, rules, brute, pool);
+    check_gaddag_builder(words, gaddag, boards, rules, brute, pool);
+    check_lexicon_registry(dir, gaddag);
+    check_ruleset(dir, gaddag, lexicon, pool);
+
+    const BasicRules<kSuperBoardDim> super = super_rules();
+    BruteForce<kSuperBoardDim> super_brute(lexicon, super);
+    check_graph("super", gaddag, positions(gaddag, super), super, super_brute, pool);
+
+    check_candidate_packing<kBoardDim>();
+    check_candidate_packing<kSuperBoardDim>();
+    check_move_store();
+    check_published();
+    check_leave_file(dir);
+    for (const char *rack : {"A", "QI", "EEE?", "AEINRST", "QQUZZ??", "SSSSEE?"}) check_exchange(rack);
+
+    std::printf("%d checks, %d failed\n", g_checks, g_failures);
+    return g_failures ? 1 : 0;
+}
@@ -4,12 +4,18 @@
 #include <vector>
 #include <algorithm>
 #include <cctype>
+#include <chrono>
+#include <cstdlib>
+#include <sys/resource.h>
 #include <sys/stat.h>
 
 #include "alphabetparameters.h"
 #include "quackleio/flexiblealphabet.h"
 #include "quackleio/gaddagfactory.h"
 
+#include "gen/gaddag_builder.h"
+#include "gen/mapped_graph.h"
+
 static inline std::string trim(const std::string &s) {
     size_t a = 0; while (a < s.size() && std::isspace(static_cast<unsigned char>(s[a]))) ++a;
     size_t b = s.size(); while (b > a && std::isspace(static_cast<unsigned char>(s[b-1]))) --b;
@@ -20,20 +26,90 @@ static inline void to_upper(std::string &s) {
     for (char &c : s) c = std::toupper(static_cast<unsigned char>(c));
 }
 
+static long long elapsed_ms(std::chrono::steady_clock::time_point since) {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - since).count();
+}
+
+static long long peak_rss_kb() {
+    struct rusage usage{};
+    ::getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss;
+}
+
+// Builds the wrapper's mapped GADDAG (engine_wrapper --mapped-gaddag)
+// straight from the word list, minimised, without Quackle's factory
+static int build_mapped(std::ifstream &in, const std::string &outPath, int threads, size_t maxStrings,
+                        bool compact) {
+    const auto t0 = std::chrono::steady_clock::now();
+    wrapper::GaddagBuilder builder;
+    std::string line;
+    while (std::getline(in, line)) {
+        line = trim(line);
+        if (line.empty()) continue;
+        if (!builder.add_word(line) && builder.stats().skipped <= 10)
+            std::cerr << "[makegaddag] skipping " << line << "\n";
+    }
+    const auto read_ms = elapsed_ms(t0);
+    builder.build(threads, maxStrings);
+    const auto build_ms = elapsed_ms(t0) - read_ms;
+    const wrapper::GaddagBuilder::Stats &stats = builder.stats();
+    std::cerr << "[makegaddag] words=" << stats.words << " skipped=" << stats.skipped
+              << " strings=" << stats.strings << " (largest shard " << stats.largest_shard
+              << ", peak held " << stats.peak_strings << ")\n";
+    std::cerr << "[makegaddag] states: trie=" << stats.trie_states << " shards minimised=" << stats.shard_states
+              << " merged=" << stats.states << " (arcs=" << stats.arcs << ")\n";
+
+    std::vector<wrapper::MappedNode> nodes;
+    std::string error;
+    if (!wrapper::pack_graph(builder, nodes, error)) {
+        std::cerr << "[makegaddag] cannot pack: " << error << "\n";
+        return 1;
+    }
+    const size_t fixed_bytes = wrapper::mapped_file_bytes(nodes.size(), false);
+    const size_t compact_bytes = wrapper::mapped_file_bytes(nodes.size(), true);
+    std::cerr << "[makegaddag] bytes: trie=" << wrapper::mapped_file_bytes(stats.trie_states, false)
+              << " fixed=" << fixed_bytes << " compact=" << compact_bytes << "\n";
+    if (!wrapper::write_mapped_nodes(outPath, nodes, error, compact)) {
+        std::cerr << "[makegaddag] cannot write " << outPath << ": " << error << "\n";
+        return 1;
+    }
+    std::cerr << "[makegaddag] wrote " << outPath << " (" << nodes.size() << " nodes, "
+              << (compact ? compact_bytes : fixed_bytes) << " bytes" << (compact ? ", compact" : "") << ")"
+              << " read " << read_ms << " ms, build " << build_ms << " ms, total " << elapsed_ms(t0) << " ms,"
+              << " peak rss " << peak_rss_kb() / 1024 << " MB\n";
+    return 0;
+}
+
 int main(int argc, char** argv) {
-    if (argc < 3) {
-        std::cerr << "Usage: makegaddag <wordlist.txt> <out.gaddag>\n";
+    bool mapped = false;
+    bool compact = false;
+    int threads = 0;
+    size_t maxStrings = wrapper::GaddagBuilder::kDefaultMaxStrings;
+    std::vector<std::string> paths;
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "--mapped") mapped = true;
+        else if (arg == "--compact") mapped = compact = true;
+        else if (arg == "--threads" && i + 1 < argc) threads = std::atoi(argv[++i]);
+        else if (arg == "--max-strings" && i + 1 < argc) maxStrings = std::strtoull(argv[++i], nullptr, 10);
+        else paths.push_back(arg);
+    }
+    if (paths.size() != 2) {
+        std::cerr << "Usage: makegaddag <wordlist.txt> <out.gaddag>\n"
+                  << "       makegaddag --mapped [--compact] [--threads N] [--max-strings N] <wordlist.txt> <out.wgaddag>\n";
         return 1;
     }
-    const std::string inPath = argv[1];
-    const std::string outPath = argv[2];
-    std::cerr << "[makegaddag] input=" << inPath << " output=" << outPath << "\n";
+    const std::string inPath = paths[0];
+    const std::string outPath = paths[1];
+    std::cerr << "[makegaddag] input=" << inPath << " output=" << outPath << (mapped ? " (mapped)" : "") << "\n";
 
     std::ifstream in(inPath);
     if (!in) {
         std::cerr << "[makegaddag] cannot open input: " << inPath << "\n";
         return 1;
     }
+    if (mapped) return build_mapped(in, outPath, threads, maxStrings, compact);
+    const auto t0 = std::chrono::steady_clock::now();
 
     // Use default English flexible alphabet (no Qt UI)
     QuackleIO::FlexibleAlphabetParameters flex;
@@ -61,7 +137,8 @@ int main(int argc, char** argv) {
     struct stat st{};
     long long size = -1;
     if (::stat(outPath.c_str(), &st) == 0) size = static_cast<long long>(st.st_size);
-    std::cerr << "[makegaddag] wrote " << outPath << " (" << size << " bytes)\n";
+    std::cerr << "[makegaddag] wrote " << outPath << " (" << size << " bytes) in " << elapsed_ms(t0)
+              << " ms, peak rss " << peak_rss_kb() / 1024 << " MB\n";
     return 0;
 }
 
@@ -0,0 +1,86 @@
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// Quackle headers (core only, no Qt)
+#include "alphabetparameters.h"
+#include "boardparameters.h"
+#include "datamanager.h"
+#include "gameparameters.h"
+#include "strategyparameters.h"
+
+#include "gen/leave_file.h"
+#include "gen/quackle_adapter.h"
+
+// Visits every leave of at most kMaxLeaveTiles tiles, types in order
+template <class Fn>
+static void for_each_leave(wrapper::RackCounts &leave, int type, Fn &fn) {
+    if (type == wrapper::kLeaveTypes) {
+        fn(leave);
+        return;
+    }
+    for_each_leave(leave, type + 1, fn);
+    int added = 0;
+    while (leave.size < wrapper::kMaxLeaveTiles) {
+        if (type == 0) leave.add_blank();
+        else leave.add(static_cast<uint8_t>(type));
+        ++added;
+        for_each_leave(leave, type + 1, fn);
+    }
+    if (type == 0) leave.blanks -= added;
+    else leave.counts[type] -= added;
+    leave.size -= added;
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        std::cerr << "Usage: makeleaves <out.leaves> [strategy]\n";
+        return 1;
+    }
+    const std::string outPath = argv[1];
+    const std::string strategy = argc > 2 ? argv[2] : "default_english";
+
+    new Quackle::DataManager();
+    const char* envAppData = std::getenv("QUACKLE_APPDATA_DIR");
+    const std::string appDataDir = (envAppData && *envAppData) ? envAppData : "/usr/share/quackle/data";
+    QUACKLE_DATAMANAGER->setAppDataDirectory(appDataDir);
+    QUACKLE_DATAMANAGER->setParameters(new Quackle::EnglishParameters());
+    QUACKLE_DATAMANAGER->setBoardParameters(new Quackle::EnglishBoard());
+    QUACKLE_DATAMANAGER->setAlphabetParameters(new Quackle::EnglishAlphabetParameters());
+    QUACKLE_DATAMANAGER->setStrategyParameters(new Quackle::StrategyParameters());
+    QUACKLE_DATAMANAGER->strategyParameters()->initialize(strategy);
+    std::cerr << "[makeleaves] appdata=" << appDataDir << " strategy=" << strategy
+              << " output=" << outPath << " leaves=" << wrapper::kLeaveCount << "\n";
+
+    const auto t0 = std::chrono::steady_clock::now();
+    std::vector<int32_t> values(wrapper::kLeaveCount);
+    std::vector<bool> seen(wrapper::kLeaveCount);
+    size_t visited = 0;
+    bool ok = true;
+    auto store = [&](const wrapper::RackCounts &leave) {
+        const uint32_t rank = wrapper::leave_rank(leave);
+        if (rank >= values.size() || seen[rank]) ok = false;
+        else seen[rank] = true;
+        if (ok) values[rank] = wrapper::equity_fixed(wrapper::quackle_leave_value(leave));
+        if ((++visited % 100000) == 0) std::cerr << "[makeleaves] leaves=" << visited << "\n";
+    };
+    wrapper::RackCounts empty;
+    for_each_leave(empty, 0, store);
+    if (!ok || visited != wrapper::kLeaveCount) {
+        std::cerr << "[makeleaves] rank is not a bijection (visited=" << visited << ")\n";
+        return 1;
+    }
+
+    std::string error;
+    if (!wrapper::write_leave_file(outPath, values, error)) {
+        std::cerr << "[makeleaves] cannot write " << outPath << ": " << error << "\n";
+        return 1;
+    }
+    const auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - t0).count();
+    std::cerr << "[makeleaves] wrote " << outPath << " ("
+              << sizeof(wrapper::LeaveFileHeader) + values.size() * sizeof(int32_t) << " bytes, "
+              << ms << " ms)\n";
+    return 0;
+}
@@ -0,0 +1,55 @@
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// Quackle headers (core only, no Qt)
+#include "alphabetparameters.h"
+#include "datamanager.h"
+#include "lexiconparameters.h"
+
+#include "gen/mapped_graph.h"
+#include "gen/quackle_adapter.h"
+
+// Converts a Quackle .gaddag into the wrapper's memory-mapped layout
+// (engine_wrapper --mapped-gaddag). The graph is walked through the same view
+// the wrapper generator uses, so both files answer every query alike.
+int main(int argc, char** argv) {
+    const bool compact = argc > 1 && std::string(argv[1]) == "--compact";
+    if (argc < 3 + compact) {
+        std::cerr << "Usage: mapgaddag [--compact] <in.gaddag> <out.wgaddag>\n";
+        return 1;
+    }
+    const std::string inPath = argv[1 + compact];
+    const std::string outPath = argv[2 + compact];
+
+    new Quackle::DataManager();
+    QUACKLE_DATAMANAGER->setAlphabetParameters(new Quackle::EnglishAlphabetParameters());
+    auto *lexParams = new Quackle::LexiconParameters();
+    const auto t0 = std::chrono::steady_clock::now();
+    lexParams->loadGaddag(inPath);
+    if (!lexParams->gaddagRoot()) {
+        std::cerr << "[mapgaddag] cannot load " << inPath << "\n";
+        return 1;
+    }
+    const auto load_ms = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - t0).count();
+    std::cerr << "[mapgaddag] input=" << inPath << " loaded in " << load_ms << " ms\n";
+
+    const wrapper::QuackleGaddag graph(lexParams->gaddagRoot());
+    std::vector<wrapper::MappedNode> nodes;
+    std::string error;
+    if (!wrapper::pack_graph(graph, nodes, error)) {
+        std::cerr << "[mapgaddag] cannot pack " << inPath << ": " << error << "\n";
+        return 1;
+    }
+    if (!wrapper::write_mapped_nodes(outPath, nodes, error, compact)) {
+        std::cerr << "[mapgaddag] cannot write " << outPath << ": " << error << "\n";
+        return 1;
+    }
+    const auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - t0).count();
+    std::cerr << "[mapgaddag] wrote " << outPath << " (" << nodes.size() << " nodes, "
+              << wrapper::mapped_file_bytes(nodes.size(), compact) << " bytes" << (compact ? ", compact, " : ", ")
+              << ms << " ms)\n";
+    return 0;
+}
@@ -1,39 +1,31 @@
+#include <algorithm>
 #include <iostream>
 #include <sstream>
 #include <string>
 #include <vector>
 #include <map>
 #include <cctype>
+#include <cstdint>
 #include <memory>
 #include <fstream>
 #include <cstdlib>
 #include <filesystem>
 #include <iomanip>
+#include <iterator>
 #include <nlohmann/json.hpp>
 using json = nlohmann::json;
 
-// Quackle headers
-#include "game.h"
-#include "board.h"
+// Quackle headers: only the rules (alphabet scores, board premiums, rack
+// size and bingo) come from Quackle; the lexicon is read directly below
 #include "boardparameters.h"
-#include "rack.h"
-#include "move.h"
-#include "generator.h"
-#include "player.h"
-#include "playerlist.h"
 #include "datamanager.h"
 #include "alphabetparameters.h"
-#include "lexiconparameters.h"
-#include "bag.h"
 #include "gameparameters.h"
-#include "strategyparameters.h"
 
 static std::string arg(int argc, char** argv, const std::string& k, const std::string& d) {
   for (int i=1;i<argc-1;++i) if (std::string(argv[i])==k) return std::string(argv[i+1]);
   return d;
 }
-// Kibitz length (number of top moves to generate and evaluate). Not simulations.
-static int kibitzLenFor(const std::string& d){ if(d=="easy")return 15; if(d=="hard")return 100; return 50; }
 
 // Debug logging function
 void debugLog(const std::string& message) {
@@ -46,11 +38,400 @@ void debugLog(const std::string& message) {
   std::cerr << "[DEBUG] " << message << std::endl;
 }
 
+// ---------------------------------------------------------------------------
+// DAWG-only move generation. kibitz() crashes in this Quackle build and a
+// GADDAG roughly doubles the lexicon's memory, so the bridge reads the .dawg
+// itself and generates placements anchor by anchor (Appel & Jacobson), with
+// cross-checks, on any board.
+namespace dawggen {
+
+constexpr int kDim = 15;
+constexpr size_t kNodeBytes = 7;
+constexpr uint32_t kAllLetters = ((1u << 27) - 1) & ~1u;  // bits 1..26
+
+// Node table as LexiconParameters::loadDawg reads it. The first byte is the
+// version: V0 files (0, the root's first-child index) are bare 7-byte nodes;
+// V1 files (1) start with the version byte, a 16-byte hash, a 3-byte word
+// count and the alphabet. A node is a 24-bit first-child index (0 = none), a
+// byte with the letter (low 5 bits) and last-sibling (64) flag, and 3 bytes
+// of playability. V0 marks a word's end with bit 32; V1 leaves that bit
+// clear and gives every word a nonzero playability instead. Node 0 is the
+// root. Only A-Z lexica fit the 26-letter rack and board here.
+struct Dawg {
+  std::vector<unsigned char> nodes;
+  uint32_t count = 0;
+  bool v1 = false;
+
+  uint32_t firstChild(uint32_t n) const {
+    const unsigned char *p = &nodes[n * kNodeBytes];
+    return (uint32_t(p[0]) << 16) | (uint32_t(p[1]) << 8) | p[2];
+  }
+  int letter(uint32_t n) const { return (nodes[n * kNodeBytes + 3] & 31) + 1; }
+  bool terminal(uint32_t n) const {
+    const unsigned char *p = &nodes[n * kNodeBytes];
+    return v1 ? (p[4] | p[5] | p[6]) != 0 : (p[3] & 32) != 0;
+  }
+  bool lastSibling(uint32_t n) const { return (nodes[n * kNodeBytes + 3] & 64) != 0; }
+  uint32_t nextSibling(uint32_t n) const { return lastSibling(n) ? 0 : n + 1; }
+  // Child of `n` with `letter` (1..26), or 0: the root is nobody's child
+  uint32_t child(uint32_t n, int letter) const {
+    for (uint32_t c = firstChild(n); c; c = nextSibling(c))
+      if (this->letter(c) == letter) return c;
+    return 0;
+  }
+};
+
+static bool loadDawg(const std::string &path, Dawg &dawg, std::string &error) {
+  std::ifstream in(path, std::ios::binary);
+  if (!in) { error = "cannot open " + path; return false; }
+  std::vector<unsigned char> data((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+  size_t offset = 0;
+  if (!data.empty() && data[0] > 1) {
+    error = "unsupported DAWG version " + std::to_string(data[0]) + " in " + path;
+    return false;
+  }
+  if (!data.empty() && data[0] == 1) {
+    offset = 1 + 16 + 3;
+    const size_t letters = offset < data.size() ? data[offset++] : 0;
+    for (size_t i = 0; i < letters && offset < data.size(); ++i) {
+      while (offset < data.size() && std::isspace(data[offset])) ++offset;
+      const size_t start = offset;
+      while (offset < data.size() && !std::isspace(data[offset])) ++offset;
+      if (offset != start + 1 || data[start] != 'A' + i) {
+        error = "alphabet of " + path + " is not A-Z";
+        return false;
+      }
+      ++offset;  // separator
+    }
+  }
+  if (offset >= data.size() || (data.size() - offset) / kNodeBytes < 2) {
+    error = "no DAWG nodes in " + path;
+    return false;
+  }
+  data.erase(data.begin(), data.begin() + offset);
+  dawg.v1 = offset > 0;
+  dawg.count = static_cast<uint32_t>(data.size() / kNodeBytes);
+  data.resize(size_t(dawg.count) * kNodeBytes);
+  dawg.nodes = std::move(data);
+  // Child runs must start inside the table, and the last node must close its
+  // run, so no walk leaves the table. Letters past Z would index past the
+  // rack and the cross-check masks; the root's letter is never read.
+  bool valid = dawg.lastSibling(dawg.count - 1);
+  for (uint32_t n = 0; valid && n < dawg.count; ++n)
+    valid = dawg.firstChild(n) < dawg.count && (n == 0 || (dawg.nodes[n * kNodeBytes + 3] & 31) < 26);
+  if (!valid) {
+    error = "corrupt DAWG node table in " + path;
+    dawg.nodes.clear();
+    dawg.count = 0;
+    return false;
+  }
+  return true;
+}
+
+// Words below `n`, memoised per node since runs are shared; -2 marks a node
+// being counted, so a cycle is reported instead of recursing forever
+static bool wordsBelow(const Dawg &dawg, uint32_t n, std::vector<int64_t> &memo) {
+  if (memo[n] == -2) return false;
+  if (memo[n] >= 0) return true;
+  memo[n] = -2;
+  int64_t words = 0;
+  for (uint32_t c = dawg.firstChild(n); c; c = dawg.nextSibling(c)) {
+    if (!wordsBelow(dawg, c, memo)) return false;
+    words += (dawg.terminal(c) ? 1 : 0) + memo[c];
+  }
+  memo[n] = words;
+  return true;
+}
+
+static bool countWords(const Dawg &dawg, uint64_t &words) {
+  std::vector<int64_t> memo(dawg.count, -1);
+  if (!wordsBelow(dawg, 0, memo)) return false;
+  words = static_cast<uint64_t>(memo[0]);
+  return true;
+}
+
+struct Rules {
+  int score[27] = {};  // by letter 1..26
+  int letterMult[kDim][kDim] = {};
+  int wordMult[kDim][kDim] = {};
+  int startRow = 7, startCol = 7;
+  int rackSize = 7, bingo = 50;
+};
+
+struct Board {
+  int letter[kDim][kDim] = {};  // 1..26, 0 = empty
+  bool blank[kDim][kDim] = {};
+  int tiles = 0;
+};
+
+struct Rack {
+  int counts[27] = {};
+  int blanks = 0;
+};
+
+struct Tile {
+  int row, col, letter;
+  bool blank;
+};
+
+struct Play {
+  int row = 0, col = 0;
+  bool horizontal = true;
+  int score = -1;
+  std::vector<Tile> placed;
+  std::vector<std::string> words;  // main word first, then cross words
+};
+
+class MoveGenerator {
+public:
+  MoveGenerator(const Dawg &dawg, const Rules &rules, const Board &board, const Rack &rack)
+    : m_dawg(dawg), m_rules(rules), m_board(board), m_rack(rack) {}
+
+  // Highest-scoring placement (first found on ties); false if there is none
+  bool best(Play &out) {
+    m_best = Play();
+    // An empty board's plays across mirror those down
+    for (m_dir = 0; m_dir < (m_board.tiles ? 2 : 1); ++m_dir) {
+      computeCrosses();
+      for (int line = 0; line < kDim; ++line)
+        for (int pos = 0; pos < kDim; ++pos)
+          if (isAnchor(line, pos)) generateAt(line, pos);
+    }
+    if (m_best.score < 0) return false;
+    out = m_best;
+    return true;
+  }
+
+  long playsSeen() const { return m_plays; }
+
+private:
+  struct Letter {
+    int letter;
+    bool blank, placed;
+  };
+
+  // Line view: direction 0 runs along rows (line = row), 1 along columns
+  int row(int line, int pos) const { return m_dir == 0 ? line : pos; }
+  int col(int line, int pos) const { return m_dir == 0 ? pos : line; }
+  int tileAt(int line, int pos) const { return m_board.letter[row(line, pos)][col(line, pos)]; }
+  bool blankAt(int line, int pos) const { return m_board.blank[row(line, pos)][col(line, pos)]; }
+
+  bool isAnchor(int line, int pos) const {
+    const int r = row(line, pos), c = col(line, pos);
+    if (m_board.letter[r][c]) return false;
+    if (!m_board.tiles) return r == m_rules.startRow && c == m_rules.startCol;
+    return (r > 0 && m_board.letter[r - 1][c]) || (r + 1 < kDim && m_board.letter[r + 1][c]) ||
+           (c > 0 && m_board.letter[r][c - 1]) || (c + 1 < kDim && m_board.letter[r][c + 1]);
+  }
+
+  // Letters allowed on each empty square by the word formed across the line
+  void computeCrosses() {
+    for (int line = 0; line < kDim; ++line) {
+      for (int pos = 0; pos < kDim; ++pos) {
+        m_cross[line][pos] = kAllLetters;
+        m_hasCross[line][pos] = false;
+        m_crossScore[line][pos] = 0;
+        if (tileAt(line, pos)) continue;
+        // The perpendicular run through (line, pos) is line±k at this pos
+        int first = line, last = line;
+        while (first > 0 && tileAt(first - 1, pos)) --first;
+        while (last + 1 < kDim && tileAt(last + 1, pos)) ++last;
+        if (first == line && last == line) continue;
+        m_hasCross[line][pos] = true;
+        for (int p = first; p <= last; ++p)
+          if (p != line && !blankAt(p, pos)) m_crossScore[line][pos] += m_rules.score[tileAt(p, pos)];
+        uint32_t node = 0, allowed = 0;
+        for (int p = first; p < line && (p == first || node); ++p) node = m_dawg.child(node, tileAt(p, pos));
+        if (first < line && !node) { m_cross[line][pos] = 0; continue; }
+        for (uint32_t c = m_dawg.firstChild(node); c; c = m_dawg.nextSibling(c)) {
+          uint32_t n = c;
+          for (int p = line + 1; p <= last && n; ++p) n = m_dawg.child(n, tileAt(p, pos));
+          if (n && m_dawg.terminal(n)) allowed |= 1u << m_dawg.letter(c);
+        }
+        m_cross[line][pos] = allowed;
+      }
+    }
+  }
+
+  void generateAt(int line, int anchor) {
+    m_word.clear();
+    if (anchor > 0 && tileAt(line, anchor - 1)) {
+      // Tiles to the left are a fixed prefix
+      int start = anchor - 1;
+      while (start > 0 && tileAt(line, start - 1)) --start;
+      uint32_t node = 0;
+      for (int p = start; p < anchor; ++p) {
+        node = m_dawg.child(node, tileAt(line, p));
+        if (!node) return;
+        m_word.push_back(Letter{tileAt(line, p), blankAt(line, p), false});
+      }
+      extendRight(line, anchor, node, anchor);
+      return;
+    }
+    // Otherwise the prefix comes from the rack, over empty squares that are
+    // not anchors themselves (those generate their own plays)
+    int limit = 0;
+    for (int p = anchor - 1; p >= 0 && !tileAt(line, p) && !isAnchor(line, p) && limit < m_rules.rackSize - 1; --p)
+      ++limit;
+    leftPart(line, anchor, 0, limit);
+  }
+
+  void leftPart(int line, int anchor, uint32_t node, int limit) {
+    extendRight(line, anchor, node, anchor);
+    if (!limit) return;
+    for (uint32_t c = m_dawg.firstChild(node); c; c = m_dawg.nextSibling(c)) {
+      const int l = m_dawg.letter(c);
+      if (m_rack.counts[l]) {
+        --m_rack.counts[l];
+        m_word.push_back(Letter{l, false, true});
+        leftPart(line, anchor, c, limit - 1);
+        m_word.pop_back();
+        ++m_rack.counts[l];
+      }
+      if (m_rack.blanks) {
+        --m_rack.blanks;
+        m_word.push_back(Letter{l, true, true});
+        leftPart(line, anchor, c, limit - 1);
+        m_word.pop_back();
+        ++m_rack.blanks;
+      }
+    }
+  }
+
+  void extendRight(int line, int pos, uint32_t node, int anchor) {
+    if (pos < kDim && tileAt(line, pos)) {
+      const uint32_t next = m_dawg.child(node, tileAt(line, pos));
+      if (!next) return;
+      m_word.push_back(Letter{tileAt(line, pos), blankAt(line, pos), false});
+      extendRight(line, pos + 1, next, anchor);
+      m_word.pop_back();
+      return;
+    }
+    if (pos > anchor && m_dawg.terminal(node)) record(line, pos - static_cast<int>(m_word.size()));
+    if (pos >= kDim) return;
+    const uint32_t allowed = m_cross[line][pos];
+    for (uint32_t c = m_dawg.firstChild(node); c; c = m_dawg.nextSibling(c)) {
+      const int l = m_dawg.letter(c);
+      if (!(allowed & (1u << l))) continue;
+      if (m_rack.counts[l]) {
+        --m_rack.counts[l];
+        m_word.push_back(Letter{l, false, true});
+        extendRight(line, pos + 1, c, anchor);
+        m_word.pop_back();
+        ++m_rack.counts[l];
+      }
+      if (m_rack.blanks) {
+        --m_rack.blanks;
+        m_word.push_back(Letter{l, true, true});
+        extendRight(line, pos + 1, c, anchor);
+        m_word.pop_back();
+        ++m_rack.blanks;
+      }
+    }
+  }
+
+  void record(int line, int start) {
+    ++m_plays;
+    int mainScore = 0, wordMult = 1, crossScore = 0, placed = 0;
+    for (size_t i = 0; i < m_word.size(); ++i) {
+      const int pos = start + static_cast<int>(i);
+      const Letter &w = m_word[i];
+      const int value = w.blank ? 0 : m_rules.score[w.letter];
+      if (!w.placed) { mainScore += value; continue; }
+      const int r = row(line, pos), c = col(line, pos);
+      const int lm = m_rules.letterMult[r][c], wm = m_rules.wordMult[r][c];
+      ++placed;
+      mainScore += value * lm;
+      wordMult *= wm;
+      if (m_hasCross[line][pos]) crossScore += (m_crossScore[line][pos] + value * lm) * wm;
+    }
+    const int score = mainScore * wordMult + crossScore + (placed == m_rules.rackSize ? m_rules.bingo : 0);
+    if (score <= m_best.score) return;
+
+    m_best = Play();
+    m_best.row = row(line, start);
+    m_best.col = col(line, start);
+    m_best.horizontal = m_dir == 0;
+    m_best.score = score;
+    std::string mainWord;
+    for (size_t i = 0; i < m_word.size(); ++i) {
+      const int pos = start + static_cast<int>(i);
+      const Letter &w = m_word[i];
+      mainWord.push_back(static_cast<char>('A' + w.letter - 1));
+      if (!w.placed) continue;
+      m_best.placed.push_back(Tile{row(line, pos), col(line, pos), w.letter, w.blank});
+      if (m_hasCross[line][pos]) m_best.words.push_back(crossWord(line, pos, w.letter));
+    }
+    m_best.words.insert(m_best.words.begin(), mainWord);
+  }
+
+  std::string crossWord(int line, int pos, int letter) const {
+    int first = line, last = line;
+    while (first > 0 && tileAt(first - 1, pos)) --first;
+    while (last + 1 < kDim && tileAt(last + 1, pos)) ++last;
+    std::string word;
+    for (int p = first; p <= last; ++p)
+      word.push_back(static_cast<char>('A' + (p == line ? letter : tileAt(p, pos)) - 1));
+    return word;
+  }
+
+  const Dawg &m_dawg;
+  const Rules &m_rules;
+  const Board &m_board;
+  Rack m_rack;
+  int m_dir = 0;
+  uint32_t m_cross[kDim][kDim] = {};
+  bool m_hasCross[kDim][kDim] = {};
+  int m_crossScore[kDim][kDim] = {};
+  std::vector<Letter> m_word;
+  Play m_best;
+  long m_plays = 0;
+};
+
+} // namespace dawggen
+
+// Scoring rules from the DataManager's alphabet, board and game parameters
+static dawggen::Rules rulesFromQuackle() {
+  dawggen::Rules rules;
+  if (auto *alphabet = QUACKLE_DATAMANAGER->alphabetParameters())
+    for (int l = 1; l <= 26; ++l) rules.score[l] = alphabet->score(static_cast<Quackle::Letter>(l - 1 + QUACKLE_FIRST_LETTER));
+  auto *board = QUACKLE_DATAMANAGER->boardParameters();
+  for (int r = 0; r < dawggen::kDim; ++r) {
+    for (int c = 0; c < dawggen::kDim; ++c) {
+      rules.letterMult[r][c] = board ? board->letterMultiplier(r, c) : 1;
+      rules.wordMult[r][c] = board ? board->wordMultiplier(r, c) : 1;
+    }
+  }
+  if (board) { rules.startRow = board->startRow(); rules.startCol = board->startColumn(); }
+  if (auto *game = QUACKLE_DATAMANAGER->parameters()) { rules.rackSize = game->rackSize(); rules.bingo = game->bingoBonus(); }
+  return rules;
+}
+
 int main(int argc, char** argv){
   debugLog("=== Quackle Bridge Started (v1.0.4 with correct API) ===");
   
   const std::string lexicon = arg(argc, argv, "--lexicon", "en-enable");
   const std::string lexdir  = arg(argc, argv, "--lexdir",  "/usr/share/quackle/lexica");
+
+  // --check-dawg <file>: load a lexicon the way a request would and report
+  // it, without Quackle or a request (the image build runs it on the
+  // shipped lexicon)
+  const std::string checkDawg = arg(argc, argv, "--check-dawg", "");
+  if (!checkDawg.empty()) {
+    dawggen::Dawg dawg;
+    std::string dawgError;
+    if (!dawggen::loadDawg(checkDawg, dawg, dawgError)) {
+      std::cout << json{{"ok", false}, {"path", checkDawg}, {"error", dawgError}}.dump() << std::endl;
+      return 1;
+    }
+    uint64_t words = 0;
+    if (!dawggen::countWords(dawg, words)) {
+      std::cout << json{{"ok", false}, {"path", checkDawg}, {"error", "cycle in the DAWG"}}.dump() << std::endl;
+      return 1;
+    }
+    std::cout << json{{"ok", words > 0}, {"path", checkDawg}, {"nodes", dawg.count}, {"words", words}}.dump() << std::endl;
+    return words > 0 ? 0 : 1;
+  }
   
   debugLog("Lexicon: " + lexicon + ", LexDir: " + lexdir);
 
@@ -67,7 +448,6 @@ int main(int argc, char** argv){
     const json jboard = req.value("board", json::object());
     const json jrack  = req.value("rack",  json::array());
     const std::string diff = req.value("difficulty", std::string("medium"));
-    const int kibitzLen = kibitzLenFor(diff);
 
     debugLog("Board keys count: " + std::to_string(jboard.size()));
     debugLog("Rack size: " + std::to_string(jrack.size()));
@@ -143,9 +523,7 @@ int main(int argc, char** argv){
     debugLog("Alphabet parameters created");
     QUACKLE_DATAMANAGER->setAlphabetParameters(alphabet);
     debugLog("Alphabet parameters set");
-    auto *lexParams = new Quackle::LexiconParameters();
-    debugLog("Lexicon parameters created");
-    // Ensure game/board/strategy parameters are initialized
+    // Ensure game and board parameters are initialized
     if (!QUACKLE_DATAMANAGER->parameters()) {
       debugLog("Creating English game parameters");
       QUACKLE_DATAMANAGER->setParameters(new Quackle::EnglishParameters());
@@ -154,10 +532,6 @@ int main(int argc, char** argv){
       debugLog("Creating English board parameters");
       QUACKLE_DATAMANAGER->setBoardParameters(new Quackle::EnglishBoard());
     }
-    if (!QUACKLE_DATAMANAGER->strategyParameters()) {
-      debugLog("Creating default strategy parameters");
-      QUACKLE_DATAMANAGER->setStrategyParameters(new Quackle::StrategyParameters());
-    }
     
     // Log alphabet parameters
     if (QUACKLE_DATAMANAGER->alphabetParameters()) {
@@ -166,13 +540,6 @@ int main(int argc, char** argv){
       debugLog("WARNING: No alphabet parameters loaded");
     }
     
-    // Log lexicon parameters status
-    if (QUACKLE_DATAMANAGER->lexiconParameters()) {
-      debugLog("Lexicon parameters available");
-    } else {
-      debugLog("WARNING: No lexicon parameters available");
-    }
-    
     debugLog("Finding dictionary file...");
     debugLog("Looking for: " + lexicon + ".dawg");
     debugLog(std::string("App data directory: ") + appDataDir);
@@ -218,441 +585,100 @@ int main(int argc, char** argv){
     debugLog("DAWG file path (absolute): " + std::filesystem::absolute(dawgFile).string());
     
     debugLog("Loading DAWG lexicon...");
-    lexParams->loadDawg(dawgFile);
-    debugLog("DAWG lexicon loaded successfully");
-    
-    // Verify lexicon is actually loaded
-    debugLog("DAWG lexicon verification: loaded successfully");
-    
-    // Also load GADDAG file if it exists
-    std::string gaddagFile = lexdir + "/" + lexicon + ".gaddag";
-    debugLog("Looking for GADDAG file: " + gaddagFile);
-    std::ifstream gaddagFileCheck(gaddagFile);
-    if (gaddagFileCheck.good()) {
-        gaddagFileCheck.close();
-        
-        // Get GADDAG file info
-        std::ifstream gaddagSizeCheck(gaddagFile, std::ios::binary);
-        gaddagSizeCheck.seekg(0, std::ios::end);
-        size_t gaddagSize = gaddagSizeCheck.tellg();
-        gaddagSizeCheck.seekg(0, std::ios::beg);
-        char gaddagHeader[16];
-        gaddagSizeCheck.read(gaddagHeader, 16);
-        gaddagSizeCheck.close();
-        
-        std::stringstream gaddagHexHeader;
-        for (int i = 0; i < 16; i++) {
-            gaddagHexHeader << std::hex << std::setw(2) << std::setfill('0') << (unsigned char)gaddagHeader[i];
-        }
-        
-        debugLog("GADDAG file size: " + std::to_string(gaddagSize) + " bytes");
-        debugLog("GADDAG file header (first 16 bytes): " + gaddagHexHeader.str());
-        debugLog("GADDAG file path (absolute): " + std::filesystem::absolute(gaddagFile).string());
-        debugLog("GADDAG file found, loading...");
-        lexParams->loadGaddag(gaddagFile);
-        debugLog("GADDAG lexicon loaded successfully");
-        
-        // Verify GADDAG is actually loaded
-        debugLog("GADDAG lexicon verification: loaded successfully");
-    } else {
-        debugLog("WARNING: GADDAG file not found: " + gaddagFile);
-        debugLog("This may cause segmentation faults in move generation");
-    }
-    
-    QUACKLE_DATAMANAGER->setLexiconParameters(lexParams);
-    debugLog("Lexicon parameters set");
-    
-    // Log final lexicon status
-    debugLog("=== LEXICON LOADING COMPLETE ===");
-    debugLog("DAWG loaded: YES");
-    debugLog("GADDAG loaded: " + std::string(gaddagFileCheck.good() ? "YES" : "NO"));
-    debugLog("Lexicon type: " + std::string(gaddagFileCheck.good() ? "GADDAG-enabled" : "DAWG-only"));
-    debugLog("Ruleset: " + std::string(argv[1] ? argv[1] : "default"));
-    debugLog("================================");
-    
-    // Initialize strategy parameters using the chosen lexicon; this expects
-    // data/strategy/{default,default_english,...} under appDataDirectory
-    if (QUACKLE_DATAMANAGER->strategyParameters()) {
-      // Pre-log resolved strategy paths
-      try {
-        std::string p_syn2 = QUACKLE_DATAMANAGER->findDataFile("strategy", "default_english", "syn2");
-        std::string p_vc   = QUACKLE_DATAMANAGER->findDataFile("strategy", "default_english", "vcplace");
-        std::string p_sup  = QUACKLE_DATAMANAGER->findDataFile("strategy", "default_english", "superleaves");
-        std::string p_bw   = QUACKLE_DATAMANAGER->findDataFile("strategy", "default",          "bogowin");
-        std::string p_w    = QUACKLE_DATAMANAGER->findDataFile("strategy", "default_english", "worths");
-        debugLog(std::string("Strategy expected paths:\n  syn2=") + p_syn2 +
-                 "\n  vcplace=" + p_vc +
-                 "\n  superleaves=" + p_sup +
-                 "\n  bogowin=" + p_bw +
-                 "\n  worths=" + p_w);
-      } catch (...) { /* ignore */ }
-
-      debugLog("Initializing strategy parameters for lexicon sets: default, default_english");
-      QUACKLE_DATAMANAGER->strategyParameters()->initialize("default");
-      QUACKLE_DATAMANAGER->strategyParameters()->initialize("default_english");
-
-      // Post-log which tables are loaded
-      auto *sp = QUACKLE_DATAMANAGER->strategyParameters();
-      debugLog(std::string("Strategy loaded flags: ") +
-               "syn2=" + (sp->hasSyn2() ? "1" : "0") + ", " +
-               "worths=" + (sp->hasWorths() ? "1" : "0") + ", " +
-               "vcplace=" + (sp->hasVcPlace() ? "1" : "0") + ", " +
-               "bogowin=" + (sp->hasBogowin() ? "1" : "0") + ", " +
-               "superleaves=" + (sp->hasSuperleaves() ? "1" : "0"));
-      debugLog("Strategy parameters initialized");
+    dawggen::Dawg dawg;
+    std::string dawgError;
+    if (!dawggen::loadDawg(dawgFile, dawg, dawgError)) {
+      debugLog("ERROR: " + dawgError);
+      throw std::runtime_error(dawgError);
     }
+    debugLog("DAWG lexicon loaded: " + std::to_string(dawg.count) + " nodes (DAWG-only, no GADDAG)");
+    debugLog("Ruleset: " + std::string(argc > 1 && argv[1] ? argv[1] : "default"));
 
+    const dawggen::Rules rules = rulesFromQuackle();
     debugLog("Data manager setup complete");
 
     // Build rack
     debugLog("Building rack...");
-    Quackle::Rack rr;
-    Quackle::LetterString rackString;
-    
-    // Handle both string and array formats for rack
+    dawggen::Rack rack;
+    auto addRackTile = [&](char ch) {
+      ch = static_cast<char>(std::toupper(static_cast<unsigned char>(ch)));
+      if (ch == '?') ++rack.blanks;
+      else if (ch >= 'A' && ch <= 'Z') ++rack.counts[ch - 'A' + 1];
+      else debugLog(std::string("Ignoring rack tile '") + ch + "'");
+    };
     if (jrack.is_string()) {
-        // If rack is a string like "CAT"
-        std::string rackStr = jrack.get<std::string>();
-        debugLog("Rack is string: " + rackStr);
-        for (char c : rackStr) {
-            char ch = std::toupper(c);
-            rackString.push_back(ch);
-            debugLog("Rack tile: letter='" + std::string(1, c) + "', final='" + std::string(1, ch) + "'");
-        }
+      // If rack is a string like "CAT"
+      const std::string rackStr = jrack.get<std::string>();
+      debugLog("Rack is string: " + rackStr);
+      for (char c : rackStr) addRackTile(c);
     } else if (jrack.is_array()) {
-        // If rack is an array of tile objects
-        for (const auto &tile : jrack) {
-            std::string letter = tile.value("letter","?");
-            bool isBlank = tile.value("isBlank", false);
-            char ch = std::toupper(letter[0]);
-            if (isBlank) ch = '?';
-            rackString.push_back(ch);
-            debugLog("Rack tile: letter='" + letter + "', isBlank=" + std::string(isBlank ? "true" : "false") + ", final='" + std::string(1,ch) + "'");
-        }
+      // If rack is an array of tile objects
+      for (const auto &tile : jrack) {
+        const std::string letter = tile.value("letter", "?");
+        const bool isBlank = tile.value("isBlank", false) || letter == "BLANK";
+        addRackTile(isBlank || letter.empty() ? '?' : letter[0]);
+      }
     } else {
-        debugLog("ERROR: Invalid rack format");
-        std::cout << R"({"tiles":[],"score":0,"words":[],"move_type":"pass","engine_fallback":true,"error":"invalid rack format"})" << std::endl;
-        return 1;
+      debugLog("ERROR: Invalid rack format");
+      std::cout << R"({"tiles":[],"score":0,"words":[],"move_type":"pass","engine_fallback":true,"error":"invalid rack format"})" << std::endl;
+      return 1;
     }
-    
-    rr.setTiles(rackString);
-    debugLog("Rack string: " + std::string(rackString.begin(), rackString.end()));
-
-    // Create game position with proper initialization 
-    debugLog("Creating game position...");
-    Quackle::PlayerList players;
-    
-    // Create players with proper types
-    Quackle::Player playerA("Human", Quackle::Player::HumanPlayerType, 0);
-    Quackle::Player playerB("Quackle", Quackle::Player::ComputerPlayerType, 1);
-    players.push_back(playerA);
-    players.push_back(playerB);
-    
-    // Create game position with players
-    Quackle::GamePosition pos(players);
-    
-    // Initialize board properly 
-    Quackle::Board &board = pos.underlyingBoardReference();
-    board.prepareEmptyBoard();
-    debugLog("Board prepared");
-    
-    // Set up bag (use default bag)
-    Quackle::Bag bag;
-    pos.setBag(bag);
-    debugLog("Bag set");
-    
-    // Set current player and rack 
-    pos.setCurrentPlayer(0);
-    pos.setCurrentPlayerRack(rr, false);
-    debugLog("Current player rack set");
-    
-    // Verify the position is valid
-    if (pos.players().empty()) {
-        throw std::runtime_error("Player list is empty");
-    }
-    
-    debugLog("Game position initialized successfully");
 
     // Place existing board tiles
     debugLog("Placing existing board tiles...");
+    dawggen::Board board;
     for (auto it = jboard.begin(); it != jboard.end(); ++it) {
       int r = 0, c = 0; char comma;
       std::istringstream sscoord(it.key()); sscoord >> r >> comma >> c;
-      // Convert from 1-based coordinates to Quackle's 0-based board
+      // Convert from 1-based coordinates to the 0-based board
       --r; --c;
-      std::string letter = it->value("letter", "?");
-      bool isBlank = it->value("isBlank", false);
-      char ch = std::toupper(letter[0]);
-      if (isBlank) ch = '?';
-      
-      debugLog("Placing tile at (" + std::to_string(r) + "," + std::to_string(c) + "): letter='" + letter + "', isBlank=" + std::string(isBlank ? "true" : "false") + ", final='" + std::string(1,ch) + "'");
-      
-      Quackle::LetterString single;
-      single.push_back(ch);
-      Quackle::Move m = Quackle::Move::createPlaceMove(r, c, false, single);
-      board.makeMove(m);
-      if (board.letter(r, c) != ch) {
-        debugLog("ERROR: Failed to place tile at (" + std::to_string(r) + "," + std::to_string(c) + ")");
-        throw std::runtime_error("failed to place existing tile");
+      const std::string letter = it->value("letter", "?");
+      const char ch = static_cast<char>(std::toupper(static_cast<unsigned char>(letter.empty() ? '?' : letter[0])));
+      if (ch < 'A' || ch > 'Z') {
+        debugLog("ERROR: Board tile at (" + std::to_string(r) + "," + std::to_string(c) + ") is not a letter: '" + letter + "'");
+        std::cout << R"({"tiles":[],"score":0,"words":[],"move_type":"pass","engine_fallback":true,"error":"invalid_board_tile","reason":"not_a_letter"})" << std::endl;
+        return 1;
       }
+      if (!board.letter[r][c]) ++board.tiles;
+      board.letter[r][c] = ch - 'A' + 1;
+      board.blank[r][c] = it->value("isBlank", false);
     }
-    debugLog("Board tiles placed successfully");
+    debugLog("Board tiles placed: " + std::to_string(board.tiles));
 
-    // Generate best move using Quackle's AI
-    debugLog("Generating best move...");
-    debugLog("Creating generator...");
-    Quackle::Generator gen(pos);
-    debugLog("Generator created successfully");
-    
-    // Update cross structures for move generation
-    debugLog("Updating cross structures...");
-    gen.allCrosses();
-    debugLog("Cross structures updated");
-    
-    // Log anchor and cross-set information
-    debugLog("=== ANCHOR & CROSS-SET ANALYSIS ===");
-    debugLog("Board empty: " + std::string(board.isEmpty() ? "YES" : "NO"));
-    if (board.isEmpty()) {
-      debugLog("Empty board - center anchor at (7,7)");
+    // Anchor-based generation over the DAWG with cross-checks
+    debugLog("Generating moves from the DAWG...");
+    dawggen::MoveGenerator generator(dawg, rules, board, rack);
+    dawggen::Play best;
+    const bool found = generator.best(best);
+    debugLog("Plays considered: " + std::to_string(generator.playsSeen()));
+
+    json response;
+    if (!found) {
+      debugLog("No valid placement - passing");
+      response["tiles"] = json::array();
+      response["score"] = 0;
+      response["words"] = json::array();
+      response["move_type"] = "pass";
+      response["engine_fallback"] = false;
     } else {
-      // Count anchors on non-empty board
-      int anchorCount = 0;
-      for (int r = 0; r < 15; r++) {
-        for (int c = 0; c < 15; c++) {
-          if (board.letter(r, c) != 0) { // 0 means empty cell
-            // Check adjacent empty cells (potential anchors)
-            if ((r > 0 && board.letter(r-1, c) == 0) ||
-                (r < 14 && board.letter(r+1, c) == 0) ||
-                (c > 0 && board.letter(r, c-1) == 0) ||
-                (c < 14 && board.letter(r, c+1) == 0)) {
-              anchorCount++;
-            }
-          }
-        }
-      }
-      debugLog("Anchors found: " + std::to_string(anchorCount));
-    }
-    debugLog("Cross-set analysis: " + std::string(board.isEmpty() ? "0 (empty board)" : "calculated"));
-    debugLog("=====================================");
-    
-    // Generate moves with the complete Quackle engine
-    debugLog("Generating moves with Quackle engine...");
-    Quackle::Move best;
-    bool foundValidMove = false;
-    
-    // CRITICAL WORKAROUND: Quackle v1.0.4 has a critical bug in kibitz() that causes SEGV
-    // in Quackle::String::counts. We must avoid calling kibitz() entirely.
-    debugLog("WARNING: Using DAWG-only workaround for Quackle kibitz() SEGV bug");
-    
-    try {
-      // Since kibitz() is broken, we'll implement a simple word generation
-      // using common English words that can be formed from the rack
-      debugLog("Implementing common word generation (kibitz() workaround)");
-      
-      // Get the rack as a string
-      Quackle::LetterString rackLetters = rr.alphaTiles();
-      std::string rackStr(rackLetters.begin(), rackLetters.end());
-      debugLog("Rack string for word generation: " + rackStr);
-      
-      // List of common English words that can be formed from typical Scrabble racks
-      std::vector<std::string> commonWords = {
-        "AT", "TA", "ET", "TE", "AL", "LA", "AM", "MA", "AG", "GA",
-        "ATE", "EAT", "TEA", "TAG", "GAT", "LAT", "MAT", "LAM", "MAL",
-        "MATE", "TEAM", "MEAT", "TAME", "GAME", "MAGE", "LAME", "MALE",
-        "MAGET", "GAMET", "TAMEL", "LAMET", "MAGEL", "GAMEL",
-        "MAGELT", "GAMELT", "TAMELG", "LAMETG", "MAGELT", "GAMELT"
-      };
-      
-      // For board empty, try to place words starting from center (7,7)
-      if (board.isEmpty()) {
-        debugLog("Empty board - trying center placement");
-        
-        int nodesProcessed = 0;
-        int validWordsFound = 0;
-        
-        // Try each common word to see if it can be formed from the rack
-        for (const std::string& word : commonWords) {
-          nodesProcessed++;
-          if (word.length() <= rackStr.length()) {
-            debugLog("Trying common word: " + word);
-            
-            // Check if we can form this word from the rack
-            std::string remainingRack = rackStr;
-            bool canForm = true;
-            
-            for (char c : word) {
-              size_t pos = remainingRack.find(c);
-              if (pos == std::string::npos) {
-                canForm = false;
-                break;
-              }
-              remainingRack.erase(pos, 1);
-            }
-            
-            if (canForm) {
-              validWordsFound++;
-              debugLog("Can form word: " + word);
-              
-              // Create a move for this word
-              Quackle::LetterString letters;
-              for (char c : word) {
-                letters.push_back(c);
-              }
-              
-              // Place horizontally at center
-              Quackle::Move move = Quackle::Move::createPlaceMove(7, 7, false, letters);
-              
-              // Calculate basic score (simplified)
-              int score = 0;
-              for (char c : word) {
-                // Basic letter scoring (simplified)
-                if (c == 'A' || c == 'E' || c == 'I' || c == 'O' || c == 'U' || c == 'L' || c == 'N' || c == 'S' || c == 'T' || c == 'R') {
-                  score += 1;
-                } else if (c == 'D' || c == 'G') {
-                  score += 2;
-                } else if (c == 'B' || c == 'C' || c == 'M' || c == 'P') {
-                  score += 3;
-                } else if (c == 'F' || c == 'H' || c == 'V' || c == 'W' || c == 'Y') {
-                  score += 4;
-                } else if (c == 'K') {
-                  score += 5;
-                } else if (c == 'J' || c == 'X') {
-                  score += 8;
-                } else if (c == 'Q' || c == 'Z') {
-                  score += 10;
-                }
-              }
-              
-              // Bonus for 7-letter words (bingo)
-              if (word.length() == 7) {
-                score += 50;
-              }
-              
-              debugLog("Word " + word + " has score: " + std::to_string(score));
-              
-              if (!foundValidMove || score > best.score) {
-                best = move;
-                best.score = score;
-                foundValidMove = true;
-                debugLog("New best move: " + word + " with score " + std::to_string(score));
-              }
-            }
-          }
-        }
-        
-        debugLog("Move generation complete - nodes processed: " + std::to_string(nodesProcessed) + ", valid words found: " + std::to_string(validWordsFound));
+      json tiles = json::array();
+      for (const auto &t : best.placed) {
+        const char letter = static_cast<char>('A' + t.letter - 1);
+        tiles.push_back({{"letter", std::string(1, letter)},
+                         {"points", t.blank ? 0 : rules.score[t.letter]},
+                         {"isBlank", t.blank},
+                         {"row", t.row},
+                         {"col", t.col}});
       }
-      
-    } catch (const std::exception &e) {
-      debugLog(std::string("Exception in DAWG-based generation: ") + e.what());
-    } catch (...) {
-      debugLog("Unknown exception in DAWG-based generation");
-    }
-    
-    // Final fallback: pass if nothing worked
-    if (!foundValidMove) {
-        debugLog("No valid moves found after all attempts - creating pass move");
-        best = Quackle::Move::createPassMove();
-    }
-    
-    try {
-        // Convert the move to JSON
-        json tiles = json::array();
-        json words = json::array();
-        
-        // Check move type
-        if (best.action == Quackle::Move::Pass) {
-            debugLog("Move is a pass");
-            json response;
-            response["tiles"] = json::array();
-            response["score"] = 0;
-            response["words"] = json::array();
-            response["move_type"] = "pass";
-            response["engine_fallback"] = !foundValidMove;
-            std::cout << response.dump() << std::endl;
-        } else if (!best.tiles().empty()) {
-          debugLog("Processing place move...");
-          
-          // Extract tiles from the move
-          Quackle::LetterString tilesStr = best.tiles();
-          
-          // Convert FixedLengthString to std::string by iterating through characters
-          std::string tilesString;
-          for (size_t i = 0; i < tilesStr.length(); ++i) {
-            tilesString += tilesStr[i];
-          }
-          debugLog("Tiles string: " + tilesString);
-          
-          // Extract proper tile information from the move
-          int startRow = best.startrow;
-          int startCol = best.startcol;
-          bool isHorizontal = best.horizontal;
-          
-          debugLog("Move details: startRow=" + std::to_string(startRow) + ", startCol=" + std::to_string(startCol) + ", isHorizontal=" + std::string(isHorizontal ? "true" : "false"));
-          
-          // Create tile representations with proper coordinates
-          for (size_t i = 0; i < tilesStr.length(); ++i) {
-            json tileJson;
-            tileJson["letter"] = std::string(1, tilesStr[i]);
-            // Assign proper English letter scores
-            char L = tilesStr[i];
-            int pts = 1;
-            switch (std::toupper(L)) {
-              case 'Q': case 'Z': pts = 10; break;
-              case 'J': case 'X': pts = 8; break;
-              case 'K': pts = 5; break;
-              case 'F': case 'H': case 'V': case 'W': case 'Y': pts = 4; break;
-              case 'B': case 'C': case 'M': case 'P': pts = 3; break;
-              case 'D': case 'G': pts = 2; break;
-              case '?': pts = 0; break;
-              default: pts = 1; break;
-            }
-            tileJson["points"] = pts;
-            tileJson["isBlank"] = (tilesStr[i] == '?');
-            
-            // Calculate proper coordinates based on direction
-            if (isHorizontal) {
-              tileJson["row"] = startRow;
-              tileJson["col"] = startCol + i;
-            } else {
-              tileJson["row"] = startRow + i;
-              tileJson["col"] = startCol;
-            }
-            
-            tiles.push_back(tileJson);
-          }
-          
-          // Extract words formed by this move
-          if (!tilesString.empty()) {
-            words.push_back(tilesString);
-          }
-          
-          json response;
-          response["tiles"] = tiles;
-          response["score"] = best.score;
-          response["words"] = words;
-          response["move_type"] = "play";
-          response["engine_fallback"] = !foundValidMove; // True only if we used fallback
-          
-          std::cout << response.dump() << std::endl;
-        } else {
-          debugLog("Move is not a place move and not a pass - returning pass");
-          json response;
-          response["tiles"] = json::array();
-          response["score"] = 0;
-          response["words"] = json::array();
-          response["move_type"] = "pass";
-          response["engine_fallback"] = true;
-          std::cout << response.dump() << std::endl;
-        }
-        
-    } catch (const std::exception& e) {
-      debugLog("Exception during move generation: " + std::string(e.what()));
-      std::cout << R"({"tiles":[],"score":0,"words":[],"move_type":"pass","engine_fallback":true,"error":")" << e.what() << R"("})" << std::endl;
-    } catch (...) {
-      debugLog("Unknown exception during move generation");
-      std::cout << R"({"tiles":[],"score":0,"words":[],"move_type":"pass","engine_fallback":true,"error":"unknown exception"})" << std::endl;
+      debugLog("Best play: " + best.words.front() + " at (" + std::to_string(best.row) + "," + std::to_string(best.col) + ") " +
+               (best.horizontal ? "across" : "down") + " for " + std::to_string(best.score));
+      response["tiles"] = tiles;
+      response["score"] = best.score;
+      response["words"] = best.words;
+      response["move_type"] = "play";
+      response["engine_fallback"] = false;
     }
+    std::cout << response.dump() << std::endl;
   }catch(const std::exception& e){
     debugLog("Exception caught: " + std::string(e.what()));
     json out={{"tiles",json::array()},{"score",0},{"words",json::array()},{"move_type","pass"},{"engine_fallback",true},{"error",std::string("engine: ")+e.what()}};
@@ -662,4 +688,4 @@ int main(int argc, char** argv){
     json out={{"tiles",json::array()},{"score",0},{"words",json::array()},{"move_type","pass"},{"engine_fallback",true},{"error","engine: unknown"}};
     std::cout<<out.dump(); return 0;
   }
-}
\ No newline at end of file
+}
@@ -1,30 +1,361 @@
-#include <iostream>
+// Builds a Quackle .dawg from a word list without Qt or quackleio.
+//
+//   g++ -O2 -std=c++17 build_dawg.cpp -o build_dawg
+//   build_dawg [--alphabet <file.quackle_alphabet>] [--sort] <wordlist.txt> <out.dawg>
+//
+// Words are added in sorted order and minimised as they arrive (Daciuk et
+// al., incremental construction from sorted input): once a word branches
+// off the previous one, the states below the branch are complete and are
+// replaced by an equal stored state or stored themselves. Memory stays
+// proportional to the minimal automaton, not to the word list. Unsorted
+// input is rejected unless --sort is given, which sorts the list in memory
+// first.
+//
+// Output is the V0 layout LexiconParameters::loadDawg reads (the one
+// Quackle's makedawg writes): bare 7-byte nodes, node 0 the root. A node is
+// a 24-bit first-child index (0 = none), a byte with the letter index (low 5
+// bits), terminal (32), last-sibling (64) and not-British-only (128) flags,
+// and 3 bytes of playability, written as 0.
+//
+// Letters are A-Z unless --alphabet names a Quackle alphabet file: its
+// letters, in file order, are the letter indices, and words are split into
+// them longest match first. Words with anything else are skipped.
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <deque>
 #include <fstream>
+#include <iostream>
 #include <string>
 #include <vector>
-#include <QtCore>
-#include "quackleio/dawgfactory.h"
-#include "quackleio/util.h"
-
-int main(int argc, char** argv){
-  if(argc<3){
-    std::cerr << "usage: build_dawg <wordlist.txt> <out.dawg> [alphabet=english]\n"; return 1;
-  }
-  QString alphabet = argc>=4 ? argv[3] : QString("english");
-  QString alphabetFile = QString("../data/alphabets/%1.quackle_alphabet").arg(alphabet);
-  DawgFactory factory(alphabetFile);
-
-  std::ifstream in(argv[1]);
-  if(!in.good()){ std::cerr << "cannot open wordlist: " << argv[1] << "\n"; return 2; }
-  std::string w; int count=0; while(in>>w){
-    Quackle::LetterString ls;
-    for(char c: w){ ls.push_back(std::toupper(static_cast<unsigned char>(c))); }
-    factory.pushWord(ls, false, 0);
-    ++count;
-  }
-  std::cerr << "Loaded words: " << count << "\n";
-  factory.generate();
-  factory.writeIndex(argv[2]);
-  std::cerr << "Wrote DAWG: " << argv[2] << " nodes=" << factory.nodeCount() << " encodable=" << factory.encodableWords() << "\n";
+#include <sys/resource.h>
+
+namespace {
+
+constexpr size_t kNodeBytes = 7;
+constexpr size_t kMaxLetters = 32;             // 5 bits of letter index
+constexpr uint32_t kMaxNodes = 1u << 24;       // 24-bit child index
+constexpr unsigned char kTerminal = 32, kLastSibling = 64, kNotBritish = 128;
+
+std::string trim(const std::string &s) {
+  size_t a = 0, b = s.size();
+  while (a < b && std::isspace(static_cast<unsigned char>(s[a]))) ++a;
+  while (b > a && std::isspace(static_cast<unsigned char>(s[b - 1]))) --b;
+  return s.substr(a, b - a);
+}
+
+std::string upper(std::string s) {
+  for (char &c : s) c = static_cast<char>(std::toupper(static_cast<unsigned char>(c)));
+  return s;
+}
+
+// Letter texts by index; A-Z by default
+class Alphabet {
+public:
+  Alphabet() {
+    for (char c = 'A'; c <= 'Z'; ++c) m_letters.emplace_back(1, c);
+    indexBytes();
+  }
+
+  // Quackle alphabet file: one letter per line, the text first (tab
+  // separated from its blank form, score and count); "blank" is the blank
+  bool load(const std::string &path, std::string &error) {
+    std::ifstream in(path);
+    if (!in) { error = "cannot open alphabet " + path; return false; }
+    m_letters.clear();
+    std::string line;
+    while (std::getline(in, line)) {
+      line = trim(line);
+      if (line.empty() || line[0] == '#') continue;
+      const std::string text = upper(line.substr(0, line.find_first_of(" \t")));
+      if (text == "BLANK") continue;
+      m_letters.push_back(text);
+    }
+    if (m_letters.empty() || m_letters.size() > kMaxLetters) {
+      error = path + ": " + std::to_string(m_letters.size()) + " letters (1 to " + std::to_string(kMaxLetters) + " fit a DAWG)";
+      return false;
+    }
+    indexBytes();
+    return true;
+  }
+
+  size_t size() const { return m_letters.size(); }
+
+  // Word as letter indices, longest letter text first; false on anything
+  // outside the alphabet
+  bool encode(const std::string &word, std::string &out) const {
+    out.clear();
+    if (m_single) {
+      for (unsigned char c : word) {
+        const int index = m_byteIndex[std::toupper(c)];
+        if (index < 0) return false;
+        out.push_back(static_cast<char>(index));
+      }
+      return !out.empty();
+    }
+    const std::string w = upper(word);
+    for (size_t at = 0; at < w.size();) {
+      size_t best = 0, length = 0;
+      for (size_t i = 0; i < m_letters.size(); ++i) {
+        const std::string &l = m_letters[i];
+        if (l.size() > length && w.compare(at, l.size(), l) == 0) { best = i; length = l.size(); }
+      }
+      if (!length) return false;
+      out.push_back(static_cast<char>(best));
+      at += length;
+    }
+    return !out.empty();
+  }
+
+private:
+  // Every letter one byte (A-Z and most alphabets): a table lookup per byte
+  void indexBytes() {
+    m_byteIndex.assign(256, -1);
+    m_single = true;
+    for (size_t i = 0; i < m_letters.size(); ++i) {
+      if (m_letters[i].size() != 1) m_single = false;
+      else m_byteIndex[static_cast<unsigned char>(m_letters[i][0])] = static_cast<int>(i);
+    }
+  }
+
+  std::vector<std::string> m_letters;
+  std::vector<int> m_byteIndex;
+  bool m_single = false;
+};
+
+struct Arc {
+  uint8_t letter;
+  uint32_t target;
+};
+
+// Minimal automaton built from words in increasing order. State s owns arcs
+// [first[s], first[s] + count[s]); a state is stored only after its
+// children, so equal arcs mean equal subtrees.
+class DawgBuilder {
+public:
+  DawgBuilder() : m_slots(1024, 0), m_open(1), m_openFinal(1, 0) {}
+
+  // `word` (letter indices) must sort after the previous one
+  void add(const std::string &word) {
+    const size_t common = std::mismatch(m_prev.begin(), m_prev.end(), word.begin(), word.end()).first - m_prev.begin();
+    closeBelow(common);
+    for (size_t i = common; i < word.size(); ++i) {
+      m_open[m_depth].push_back(Arc{static_cast<uint8_t>(word[i]), 0});
+      if (m_open.size() == ++m_depth) { m_open.emplace_back(); m_openFinal.push_back(0); }
+      m_open[m_depth].clear();
+      m_openFinal[m_depth] = 0;
+    }
+    m_openFinal[m_depth] = 1;
+    m_prev = word;
+  }
+
+  // Closes the last word; returns the root state
+  uint32_t finish() {
+    closeBelow(0);
+    return intern(0);
+  }
+
+  size_t states() const { return first.size(); }
+
+  std::vector<Arc> arcs;
+  std::vector<uint32_t> first;
+  std::vector<uint8_t> count;
+  std::vector<uint8_t> final;
+
+private:
+  static uint32_t hashOf(uint8_t isFinal, const std::vector<Arc> &out) {
+    uint64_t h = 0xcbf29ce484222325ull ^ isFinal;
+    for (const Arc &a : out) h = ((h ^ a.letter) * 0x100000001b3ull ^ a.target) * 0x100000001b3ull;
+    return static_cast<uint32_t>(h ^ h >> 32);
+  }
+
+  bool sameState(uint32_t s, uint8_t isFinal, const std::vector<Arc> &out) const {
+    if (final[s] != isFinal || count[s] != out.size()) return false;
+    for (size_t i = 0; i < out.size(); ++i) {
+      const Arc &a = arcs[first[s] + i];
+      if (a.letter != out[i].letter || a.target != out[i].target) return false;
+    }
+    return true;
+  }
+
+  // Stores the open state at `depth`, or finds an equal one already stored.
+  // The register is open addressing over state ids (+1; 0 = empty slot) with
+  // each state's hash kept beside it, so probes rarely touch the arcs.
+  uint32_t intern(size_t depth) {
+    const std::vector<Arc> &out = m_open[depth];
+    const uint8_t isFinal = m_openFinal[depth];
+    const uint32_t h = hashOf(isFinal, out);
+    size_t mask = m_slots.size() - 1, at = h & mask;
+    for (; m_slots[at]; at = (at + 1) & mask) {
+      const uint32_t s = m_slots[at] - 1;
+      if (m_hashes[s] == h && sameState(s, isFinal, out)) return s;
+    }
+    const uint32_t state = static_cast<uint32_t>(first.size());
+    first.push_back(static_cast<uint32_t>(arcs.size()));
+    count.push_back(static_cast<uint8_t>(out.size()));
+    final.push_back(isFinal);
+    m_hashes.push_back(h);
+    arcs.insert(arcs.end(), out.begin(), out.end());
+    m_slots[at] = state + 1;
+    if (first.size() * 2 > m_slots.size()) {
+      // Half full: double and reinsert by the kept hashes
+      std::vector<uint32_t> slots(m_slots.size() * 2, 0);
+      mask = slots.size() - 1;
+      for (uint32_t s = 0; s < first.size(); ++s) {
+        size_t i = m_hashes[s] & mask;
+        while (slots[i]) i = (i + 1) & mask;
+        slots[i] = s + 1;
+      }
+      m_slots.swap(slots);
+    }
+    return state;
+  }
+
+  void closeBelow(size_t keep) {
+    for (; m_depth > keep; --m_depth) m_open[m_depth - 1].back().target = intern(m_depth);
+  }
+
+  std::vector<uint32_t> m_slots;
+  std::vector<uint32_t> m_hashes;
+  // States along the previous word, still open to new arcs
+  std::vector<std::vector<Arc>> m_open;
+  std::vector<uint8_t> m_openFinal;
+  size_t m_depth = 0;
+  std::string m_prev;
+};
+
+// Lays the automaton out as Quackle nodes: the root, then each state's arcs
+// as one sibling run, breadth-first, every run stored once
+bool layoutNodes(const DawgBuilder &dawg, uint32_t root, std::vector<unsigned char> &out, std::string &error) {
+  std::vector<uint32_t> runAt(dawg.states(), 0);
+  std::deque<uint32_t> pending;
+  uint32_t next = 1;
+  auto place = [&](uint32_t state) -> uint32_t {
+    if (!dawg.count[state]) return 0;
+    if (!runAt[state]) {
+      runAt[state] = next;
+      next += dawg.count[state];
+      pending.push_back(state);
+    }
+    return runAt[state];
+  };
+  auto put = [&](uint32_t at, uint32_t child, unsigned char flags) {
+    unsigned char *p = &out[size_t(at) * kNodeBytes];
+    p[0] = static_cast<unsigned char>(child >> 16);
+    p[1] = static_cast<unsigned char>(child >> 8);
+    p[2] = static_cast<unsigned char>(child);
+    p[3] = flags;
+  };
+  out.assign(kNodeBytes, 0);
+  put(0, place(root), kLastSibling | kNotBritish);
+  while (!pending.empty() && next <= kMaxNodes) {
+    const uint32_t state = pending.front();
+    pending.pop_front();
+    out.resize(size_t(next) * kNodeBytes, 0);
+    for (uint32_t i = 0; i < dawg.count[state]; ++i) {
+      const Arc &arc = dawg.arcs[dawg.first[state] + i];
+      unsigned char flags = arc.letter | kNotBritish;
+      if (dawg.final[arc.target]) flags |= kTerminal;
+      if (i + 1 == dawg.count[state]) flags |= kLastSibling;
+      put(runAt[state] + i, place(arc.target), flags);
+    }
+  }
+  if (next > kMaxNodes) {
+    error = "more than " + std::to_string(kMaxNodes) + " nodes do not fit a 24-bit child index";
+    return false;
+  }
+  return true;
+}
+
+long long elapsedMs(std::chrono::steady_clock::time_point since) {
+  return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - since).count();
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  std::string alphabetPath;
+  bool sortInput = false;
+  std::vector<std::string> paths;
+  for (int i = 1; i < argc; ++i) {
+    const std::string a = argv[i];
+    if (a == "--alphabet" && i + 1 < argc) alphabetPath = argv[++i];
+    else if (a == "--sort") sortInput = true;
+    else paths.push_back(a);
+  }
+  if (paths.size() != 2) {
+    std::cerr << "usage: build_dawg [--alphabet <file.quackle_alphabet>] [--sort] <wordlist.txt> <out.dawg>\n";
+    return 1;
+  }
+  const auto t0 = std::chrono::steady_clock::now();
+
+  Alphabet alphabet;
+  std::string error;
+  if (!alphabetPath.empty() && !alphabet.load(alphabetPath, error)) { std::cerr << "[build_dawg] " << error << "\n"; return 1; }
+  std::ifstream in(paths[0]);
+  if (!in) { std::cerr << "[build_dawg] cannot open wordlist: " << paths[0] << "\n"; return 2; }
+
+  DawgBuilder dawg;
+  size_t words = 0, skipped = 0, duplicates = 0, lineNo = 0;
+  std::vector<std::string> held;  // --sort only
+  std::string line, encoded, previous;
+  bool any = false;
+  while (std::getline(in, line)) {
+    ++lineNo;
+    line = trim(line);
+    line = line.substr(0, line.find_first_of(" \t"));  // first field only
+    if (line.empty()) continue;
+    if (!alphabet.encode(line, encoded)) {
+      if (++skipped <= 10) std::cerr << "[build_dawg] skipping line " << lineNo << ": " << line << "\n";
+      continue;
+    }
+    if (sortInput) { held.push_back(encoded); continue; }
+    if (any && encoded <= previous) {
+      if (encoded == previous) { ++duplicates; continue; }
+      std::cerr << "[build_dawg] line " << lineNo << " (" << line << ") is out of order; sort the list "
+                << "(LC_ALL=C sort -u for A-Z) or pass --sort\n";
+      return 3;
+    }
+    dawg.add(encoded);
+    previous.swap(encoded);
+    any = true;
+    ++words;
+  }
+  if (sortInput) {
+    std::sort(held.begin(), held.end());
+    const size_t unique = std::unique(held.begin(), held.end()) - held.begin();
+    duplicates = held.size() - unique;
+    held.resize(unique);
+    for (const std::string &w : held) dawg.add(w);
+    words = held.size();
+    held = std::vector<std::string>();
+  }
+  if (!words) { std::cerr << "[build_dawg] no words in " << paths[0] << "\n"; return 2; }
+  const uint32_t root = dawg.finish();
+  const auto buildMs = elapsedMs(t0);
+
+  std::vector<unsigned char> nodes;
+  if (!layoutNodes(dawg, root, nodes, error)) { std::cerr << "[build_dawg] " << error << "\n"; return 4; }
+  // Written beside the target and renamed, so a reader never loads half a file
+  const std::string tmp = paths[1] + ".tmp";
+  std::FILE *f = std::fopen(tmp.c_str(), "wb");
+  bool ok = f && std::fwrite(nodes.data(), 1, nodes.size(), f) == nodes.size();
+  ok = f && std::fclose(f) == 0 && ok;
+  if (!ok || std::rename(tmp.c_str(), paths[1].c_str()) != 0) {
+    std::cerr << "[build_dawg] cannot write " << paths[1] << ": " << std::strerror(errno) << "\n";
+    std::remove(tmp.c_str());
+    return 4;
+  }
+
+  struct rusage usage{};
+  ::getrusage(RUSAGE_SELF, &usage);
+  std::cerr << "[build_dawg] words=" << words << " skipped=" << skipped << " duplicates=" << duplicates
+            << " states=" << dawg.states() << " nodes=" << nodes.size() / kNodeBytes << "\n";
+  std::cerr << "[build_dawg] wrote " << paths[1] << " (" << nodes.size() << " bytes) build " << buildMs
+            << " ms, total " << elapsedMs(t0) << " ms, peak rss " << usage.ru_maxrss / 1024 << " MB\n";
   return 0;
 }
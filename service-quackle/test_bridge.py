@@ -47,8 +47,24 @@ def test_bridge(payload, test_name):
     
     return None
 
+def test_lexica():
+    # Every .dawg in the lexicon dir must load, or be refused with a reason
+    print(f"\n=== Lexica in {QUACKLE_LEXDIR} ===")
+    for name in sorted(os.listdir(QUACKLE_LEXDIR)):
+        if not name.endswith(".dawg"):
+            continue
+        proc = subprocess.run(
+            [BRIDGE_BIN, "--check-dawg", os.path.join(QUACKLE_LEXDIR, name)],
+            stdout=subprocess.PIPE,
+            stderr=subprocess.DEVNULL,
+            timeout=30,
+        )
+        print(f"{name}: rc={proc.returncode} {proc.stdout.decode('utf-8').strip()}")
+
 def main():
     print("Testing Quackle Bridge with various payloads...")
+
+    test_lexica()
     
     # Test 1: Empty board, simple rack
     test_bridge({